@@ -0,0 +1,320 @@
+#include "s21_batch_matrix.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "s21_thread_pool.h"
+
+template <typename T>
+S21BasicBatchMatrix<T>::S21BasicBatchMatrix(int count, int rows, int cols)
+    : count_(count), rows_(rows), cols_(cols) {
+  if (count_ <= 0 || rows_ <= 0 || cols_ <= 0)
+    throw std::out_of_range(
+        "Incorrect input, batch and matrix sizes should be positive");
+  const int padded = (count_ + kLanes - 1) / kLanes * kLanes;
+  planes_ = Matrix(rows_ * cols_, padded);
+}
+
+template <typename T>
+void S21BasicBatchMatrix<T>::check_index(int b) const {
+  if (b >= count_) throw std::out_of_range("Error! Value is out of range");
+  if (b < 0) throw std::out_of_range("Error! Values should be positive");
+}
+
+template <typename T>
+void S21BasicBatchMatrix<T>::Set(int b, const Matrix &matrix) {
+  if (matrix.getRows() != rows_ || matrix.getCols() != cols_)
+    throw std::out_of_range(
+        "Incorrect input, matrices should have the same size");
+  check_index(b);
+  for (int i = 0; i < rows_; i++)
+    for (int j = 0; j < cols_; j++) at_unchecked(b, i, j) = matrix.eval(i, j);
+}
+
+template <typename T>
+S21BasicMatrix<T> S21BasicBatchMatrix<T>::Get(int b) const {
+  check_index(b);
+  Matrix sol(rows_, cols_);
+  for (int i = 0; i < rows_; i++)
+    for (int j = 0; j < cols_; j++)
+      sol.at_unchecked(i, j) = at_unchecked(b, i, j);
+  return sol;
+}
+
+// Products: one accumulator lane per matrix of the block
+
+template <typename T>
+void S21BasicBatchMatrix<T>::MulMatrix(const S21BasicBatchMatrix &other) {
+  Multiply(*this, *this, other);
+}
+
+template <typename T>
+void S21BasicBatchMatrix<T>::Multiply(S21BasicBatchMatrix &C,
+                                      const S21BasicBatchMatrix &A,
+                                      const S21BasicBatchMatrix &B) {
+  if (A.count_ != B.count_ || A.cols_ != B.rows_)
+    throw std::out_of_range(
+        "Incorrect input, matrices should have the same size");
+  const int m = A.rows_, n = B.cols_, k = A.cols_;
+  if (&C == &A || &C == &B) {
+    S21BasicBatchMatrix sol(A.count_, m, n);
+    Multiply(sol, A, B);
+    C = std::move(sol);
+    return;
+  }
+  if (C.count_ != A.count_ || C.rows_ != m || C.cols_ != n)
+    C = S21BasicBatchMatrix(A.count_, m, n);
+  const long ld = A.stride();
+  const T *a = A.data();
+  const T *b = B.data();
+  T *c = C.data();
+  S21ThreadPool::ParallelFor(
+      0, A.blocks(), A.blocks() * kLanes * m * n * k,
+      [&](long first, long last) {
+        for (long block = first; block < last; block++) {
+          const long lane0 = block * kLanes;
+          for (int i = 0; i < m; i++) {
+            for (int j = 0; j < n; j++) {
+              T acc[kLanes] = {};
+              for (int p = 0; p < k; p++) {
+                const T *x = a + (i * k + p) * ld + lane0;
+                const T *y = b + (p * n + j) * ld + lane0;
+                for (int l = 0; l < kLanes; l++) acc[l] += x[l] * y[l];
+              }
+              T *z = c + (i * n + j) * ld + lane0;
+              for (int l = 0; l < kLanes; l++) z[l] = acc[l];
+            }
+          }
+        }
+      });
+}
+
+template <typename T>
+S21BasicBatchMatrix<T> S21BasicBatchMatrix<T>::Transpose() const {
+  S21BasicBatchMatrix sol(count_, cols_, rows_);
+  // whole planes move, element (i, j) becomes (j, i)
+  for (int i = 0; i < rows_; i++)
+    for (int j = 0; j < cols_; j++)
+      std::copy_n(data() + static_cast<long>(i * cols_ + j) * stride(),
+                  stride(), sol.data() + static_cast<long>(j * rows_ + i) *
+                                             sol.stride());
+  return sol;
+}
+
+// Elimination with partial pivoting, kLanes matrices at a time. Every lane
+// picks its own pivot row; rows are exchanged with per-lane selects so
+// that all lanes keep running the same instructions. Lanes whose pivot is
+// at round-off level are marked singular and continue on a unit pivot.
+
+namespace {
+
+template <typename T, int L>
+struct Lanes {
+  using real_type = typename S21ScalarTraits<T>::real_type;
+
+  int n;
+  std::vector<T> a;  // n x n block, element (i, j) of lane l at
+                     // a[(i * n + j) * L + l]
+  std::vector<T> x;  // Right-hand side rows for Gauss-Jordan, same layout
+  int pivot[L];
+  real_type tiny[L];
+  bool singular[L];
+
+  explicit Lanes(int size) : n(size), a(n * n * L), x() {}
+
+  T *at(std::vector<T> &m, int i, int j) { return m.data() + (i * n + j) * L; }
+
+  void load(const T *planes, long ld, long lane0) {
+    for (int p = 0; p < n * n; p++)
+      std::copy_n(planes + p * ld + lane0, L, a.data() + p * L);
+    for (int l = 0; l < L; l++) {
+      real_type scale = 0;
+      for (int p = 0; p < n * n; p++)
+        scale = std::max<real_type>(scale, std::abs(a[p * L + l]));
+      tiny[l] = n * std::numeric_limits<real_type>::epsilon() * scale;
+      singular[l] = false;
+    }
+  }
+
+  // Selects the pivot of column k in every lane and swaps it into row k,
+  // in a and, when present, in x. Lanes whose pivot is at round-off level
+  // of their own elements are flagged singular, as in S21BasicLU.
+  void choose_pivot(int k) {
+    real_type max[L];
+    for (int l = 0; l < L; l++) {
+      pivot[l] = k;
+      max[l] = std::abs(at(a, k, k)[l]);
+    }
+    for (int i = k + 1; i < n; i++) {
+      const T *column = at(a, i, k);
+      for (int l = 0; l < L; l++) {
+        const real_type value = std::abs(column[l]);
+        const bool larger = value > max[l];
+        max[l] = larger ? value : max[l];
+        pivot[l] = larger ? i : pivot[l];
+      }
+    }
+    for (int l = 0; l < L; l++)
+      singular[l] = singular[l] || max[l] <= tiny[l];
+    for (int i = k + 1; i < n; i++) {
+      swap_rows(a, k, i, k);
+      if (!x.empty()) swap_rows(x, k, i, 0);
+    }
+  }
+
+  void swap_rows(std::vector<T> &m, int k, int i, int from) {
+    for (int j = from; j < n; j++) {
+      T *row_k = at(m, k, j);
+      T *row_i = at(m, i, j);
+      for (int l = 0; l < L; l++) {
+        const bool swap = pivot[l] == i;
+        const T u = row_k[l], v = row_i[l];
+        row_k[l] = swap ? v : u;
+        row_i[l] = swap ? u : v;
+      }
+    }
+  }
+
+  // 1 / pivot of column k, 1 for singular lanes so they stay finite
+  void inverse_pivot(int k, T *inv) {
+    const T *diagonal = at(a, k, k);
+    for (int l = 0; l < L; l++)
+      inv[l] = singular[l] ? T(1) : T(1) / diagonal[l];
+  }
+};
+
+}  // namespace
+
+template <typename T>
+std::vector<T> S21BasicBatchMatrix<T>::Determinant() const {
+  if (rows_ != cols_)
+    throw std::out_of_range(
+        "Incorrect input, matrices should have the same size");
+  const int n = rows_;
+  std::vector<T> sol(planes_.getCols());
+  S21ThreadPool::ParallelFor(
+      0, blocks(), blocks() * kLanes * n * n * n,
+      [&](long first, long last) {
+        Lanes<T, kLanes> w(n);
+        for (long block = first; block < last; block++) {
+          const long lane0 = block * kLanes;
+          w.load(data(), stride(), lane0);
+          T det[kLanes];
+          std::fill_n(det, kLanes, T(1));
+          for (int k = 0; k < n; k++) {
+            w.choose_pivot(k);
+            T inv[kLanes];
+            w.inverse_pivot(k, inv);
+            const T *row_k = w.at(w.a, k, 0);
+            for (int l = 0; l < kLanes; l++)
+              det[l] *= (w.pivot[l] != k ? T(-1) : T(1)) *
+                        (w.singular[l] ? T(1) : row_k[k * kLanes + l]);
+            for (int i = k + 1; i < n; i++) {
+              T *row_i = w.at(w.a, i, 0);
+              T factor[kLanes];
+              for (int l = 0; l < kLanes; l++)
+                factor[l] = row_i[k * kLanes + l] * inv[l];
+              for (int j = k + 1; j < n; j++)
+                for (int l = 0; l < kLanes; l++)
+                  row_i[j * kLanes + l] -= factor[l] * row_k[j * kLanes + l];
+            }
+          }
+          for (int l = 0; l < kLanes; l++)
+            sol[lane0 + l] = w.singular[l] ? T(0) : det[l];
+        }
+      });
+  sol.resize(count_);
+  return sol;
+}
+
+// Gauss-Jordan on [A | I]: after normalizing and clearing every column,
+// the right half holds the inverse
+template <typename T>
+S21BasicBatchMatrix<T> S21BasicBatchMatrix<T>::InverseMatrix() const {
+  if (rows_ != cols_)
+    throw std::out_of_range(
+        "Incorrect input, matrices should have the same size");
+  const int n = rows_;
+  S21BasicBatchMatrix sol(count_, n, n);
+  std::vector<char> failed(blocks(), 0);
+  S21ThreadPool::ParallelFor(
+      0, blocks(), blocks() * kLanes * n * n * n,
+      [&](long first, long last) {
+        Lanes<T, kLanes> w(n);
+        for (long block = first; block < last; block++) {
+          const long lane0 = block * kLanes;
+          w.load(data(), stride(), lane0);
+          w.x.assign(n * n * kLanes, T(0));
+          for (int i = 0; i < n; i++)
+            std::fill_n(w.at(w.x, i, i), kLanes, T(1));
+          for (int k = 0; k < n; k++) {
+            w.choose_pivot(k);
+            T inv[kLanes];
+            w.inverse_pivot(k, inv);
+            T *a_k = w.at(w.a, k, 0);
+            T *x_k = w.at(w.x, k, 0);
+            for (int j = 0; j < n; j++) {
+              for (int l = 0; l < kLanes; l++) {
+                a_k[j * kLanes + l] *= inv[l];
+                x_k[j * kLanes + l] *= inv[l];
+              }
+            }
+            for (int i = 0; i < n; i++) {
+              if (i == k) continue;
+              T *a_i = w.at(w.a, i, 0);
+              T *x_i = w.at(w.x, i, 0);
+              T factor[kLanes];
+              for (int l = 0; l < kLanes; l++) factor[l] = a_i[k * kLanes + l];
+              for (int j = 0; j < n; j++) {
+                for (int l = 0; l < kLanes; l++) {
+                  a_i[j * kLanes + l] -= factor[l] * a_k[j * kLanes + l];
+                  x_i[j * kLanes + l] -= factor[l] * x_k[j * kLanes + l];
+                }
+              }
+            }
+          }
+          for (int l = 0; l < kLanes && lane0 + l < count_; l++)
+            if (w.singular[l]) failed[block] = 1;
+          for (int p = 0; p < n * n; p++)
+            std::copy_n(w.x.data() + p * kLanes, kLanes,
+                        sol.data() + p * sol.stride() + lane0);
+        }
+      });
+  if (std::find(failed.begin(), failed.end(), 1) != failed.end())
+    throw std::out_of_range("Determinant = 0");
+  return sol;
+}
+
+// overload
+
+template <typename T>
+S21BasicBatchMatrix<T> S21BasicBatchMatrix<T>::operator*(
+    const S21BasicBatchMatrix &A) const {
+  S21BasicBatchMatrix sol(count_, rows_, A.cols_);
+  Multiply(sol, *this, A);
+  return sol;
+}
+
+template <typename T>
+T &S21BasicBatchMatrix<T>::operator()(int b, int i, int j) {
+  if (b >= count_ || i >= rows_ || j >= cols_)
+    throw std::out_of_range("Error! Value is out of range");
+  if (b < 0 || i < 0 || j < 0)
+    throw std::out_of_range("Error! Values should be positive");
+  return planes_.data()[static_cast<long>(i * cols_ + j) * stride() + b];
+}
+
+template <typename T>
+const T &S21BasicBatchMatrix<T>::operator()(int b, int i, int j) const {
+  if (b >= count_ || i >= rows_ || j >= cols_)
+    throw std::out_of_range("Error! Value is out of range");
+  if (b < 0 || i < 0 || j < 0)
+    throw std::out_of_range("Error! Values should be positive");
+  return planes_.data()[static_cast<long>(i * cols_ + j) * stride() + b];
+}
+
+template class S21BasicBatchMatrix<float>;
+template class S21BasicBatchMatrix<double>;
+template class S21BasicBatchMatrix<long double>;
+template class S21BasicBatchMatrix<std::complex<double>>;
@@ -0,0 +1,82 @@
+#ifndef MATRIX_SRC_S21_BATCH_MATRIX_H
+#define MATRIX_SRC_S21_BATCH_MATRIX_H
+
+#include <complex>
+#include <vector>
+
+#include "s21_matrix_oop.h"
+
+// A batch of equally shaped small matrices stored structure-of-arrays:
+// element (i, j) of every matrix is one contiguous plane, so matrix b's
+// element lives at data()[(i * getCols() + j) * stride() + b]. The batch
+// is padded to a multiple of kLanes; every operation runs on blocks of
+// kLanes matrices with fixed-length inner loops the compiler turns into
+// vector instructions, and the blocks are spread over the thread pool.
+// The whole batch is one allocation.
+template <typename T>
+class S21BasicBatchMatrix {
+ public:
+  using value_type = T;
+  using real_type = typename S21ScalarTraits<T>::real_type;
+  using Matrix = S21BasicMatrix<T>;
+  // Matrices processed side by side by the kernels
+  static constexpr int kLanes = 8;
+
+ private:
+  // Attributes
+  int count_, rows_, cols_;
+  Matrix planes_;  // rows_ * cols_ planes of stride() elements
+
+  [[nodiscard]] long blocks() const noexcept {
+    return planes_.getCols() / kLanes;
+  }
+  void check_index(int b) const;
+
+ public:
+  S21BasicBatchMatrix(int count, int rows, int cols);
+
+  [[nodiscard]] int getCount() const noexcept { return count_; }
+  [[nodiscard]] int getRows() const noexcept { return rows_; }
+  [[nodiscard]] int getCols() const noexcept { return cols_; }
+  [[nodiscard]] T *data() noexcept { return planes_.data(); }
+  [[nodiscard]] const T *data() const noexcept { return planes_.data(); }
+  [[nodiscard]] int stride() const noexcept { return planes_.stride(); }
+
+  // Copies one matrix in or out of the batch
+  void Set(int b, const Matrix &matrix);
+  [[nodiscard]] Matrix Get(int b) const;
+
+  // Each operation applies to matrix b of every operand, for every b
+  void MulMatrix(const S21BasicBatchMatrix &other);
+  // C = A * B reusing C's storage when it already has the product's shape;
+  // C may alias A or B
+  static void Multiply(S21BasicBatchMatrix &C, const S21BasicBatchMatrix &A,
+                       const S21BasicBatchMatrix &B);
+  [[nodiscard]] S21BasicBatchMatrix Transpose() const;
+  [[nodiscard]] std::vector<T> Determinant() const;
+  [[nodiscard]] S21BasicBatchMatrix InverseMatrix() const;
+
+  S21BasicBatchMatrix operator*(const S21BasicBatchMatrix &A) const;
+  T &operator()(int b, int i, int j);
+  const T &operator()(int b, int i, int j) const;
+  // Element (i, j) of matrix b, checked only by assert()
+  [[nodiscard]] T &at_unchecked(int b, int i, int j) noexcept {
+    assert(b >= 0 && b < count_ && i >= 0 && i < rows_ && j >= 0 &&
+           j < cols_);
+    return planes_.at_unchecked(i * cols_ + j, b);
+  }
+  [[nodiscard]] const T &at_unchecked(int b, int i, int j) const noexcept {
+    assert(b >= 0 && b < count_ && i >= 0 && i < rows_ && j >= 0 &&
+           j < cols_);
+    return planes_.at_unchecked(i * cols_ + j, b);
+  }
+};
+
+using S21BatchMatrix = S21BasicBatchMatrix<double>;
+
+extern template class S21BasicBatchMatrix<float>;
+extern template class S21BasicBatchMatrix<double>;
+extern template class S21BasicBatchMatrix<long double>;
+extern template class S21BasicBatchMatrix<std::complex<double>>;
+
+#endif  // MATRIX_SRC_S21_BATCH_MATRIX_H
@@ -0,0 +1,374 @@
+#ifndef MATRIX_SRC_S21_FIXED_MATRIX_H
+#define MATRIX_SRC_S21_FIXED_MATRIX_H
+
+#include <array>
+#include <cmath>
+#include <complex>
+#include <cstddef>
+#include <initializer_list>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+
+#include "s21_matrix_oop.h"
+
+// Matrix with compile-time dimensions kept inline in a std::array: no heap
+// allocation, no bounds checks in operator() and loops the compiler fully
+// unrolls. Meant for 2x2 .. 4x4 transforms; Determinant and InverseMatrix
+// use closed forms up to 4x4 and Gauss-Jordan elimination above. Almost
+// everything is constexpr. Element types and comparison tolerances are
+// those of S21BasicMatrix, complex ones included.
+template <typename T, int R, int C>
+class S21FixedMatrix {
+  static_assert(R > 0 && C > 0, "S21FixedMatrix dimensions should be positive");
+
+ public:
+  using real_type = typename S21ScalarTraits<T>::real_type;
+
+ private:
+  std::array<T, static_cast<std::size_t>(R) * C> matrix_{};
+
+  static constexpr real_type minimum_diff_ = S21ScalarTraits<T>::kMinimumDiff;
+
+  // std::abs is not constexpr before C++23, real types keep their own
+  [[nodiscard]] static constexpr real_type abs_value(T x) noexcept {
+    if constexpr (std::is_arithmetic_v<T>)
+      return x < T(0) ? -x : x;
+    else
+      return std::abs(x);
+  }
+
+  // Singularity is judged relative to the scale of the matrix, as in
+  // S21BasicLU: a pivot at or below R * epsilon * max|a_ij| counts as zero,
+  // and so does a closed-form determinant at or below R * epsilon * max|a|^R
+  [[nodiscard]] constexpr real_type max_abs() const noexcept {
+    real_type scale = 0;
+    for (const T &value : matrix_)
+      if (abs_value(value) > scale) scale = abs_value(value);
+    return scale;
+  }
+  [[nodiscard]] constexpr real_type pivot_tolerance() const noexcept {
+    return R * std::numeric_limits<real_type>::epsilon() * max_abs();
+  }
+  [[nodiscard]] constexpr bool singular_determinant(T det) const noexcept {
+    const real_type scale = max_abs();
+    real_type level = R * std::numeric_limits<real_type>::epsilon();
+    for (int k = 0; k < R; k++) level *= scale;
+    return abs_value(det) <= level;
+  }
+
+  // Gaussian elimination with partial pivoting on a copy, any size
+  [[nodiscard]] constexpr T determinant_elimination() const noexcept {
+    S21FixedMatrix a(*this);
+    T det = T(1);
+    for (int k = 0; k < R; k++) {
+      int p = k;
+      for (int i = k + 1; i < R; i++)
+        if (abs_value(a(i, k)) > abs_value(a(p, k))) p = i;
+      if (a(p, k) == T(0)) return T(0);
+      if (p != k) {
+        for (int j = 0; j < C; j++) {
+          T t = a(k, j);
+          a(k, j) = a(p, j);
+          a(p, j) = t;
+        }
+        det = -det;
+      }
+      det *= a(k, k);
+      for (int i = k + 1; i < R; i++) {
+        T l = a(i, k) / a(k, k);
+        for (int j = k + 1; j < C; j++) a(i, j) -= l * a(k, j);
+      }
+    }
+    return det;
+  }
+
+  [[nodiscard]] constexpr S21FixedMatrix inverse_elimination() const {
+    S21FixedMatrix a(*this);
+    S21FixedMatrix inv = Identity();
+    const real_type tiny = pivot_tolerance();
+    for (int k = 0; k < R; k++) {
+      int p = k;
+      for (int i = k + 1; i < R; i++)
+        if (abs_value(a(i, k)) > abs_value(a(p, k))) p = i;
+      if (abs_value(a(p, k)) <= tiny)
+        throw std::out_of_range("Determinant = 0");
+      for (int j = 0; j < C; j++) {
+        T t = a(k, j);
+        a(k, j) = a(p, j);
+        a(p, j) = t;
+        t = inv(k, j);
+        inv(k, j) = inv(p, j);
+        inv(p, j) = t;
+      }
+      const T pivot = a(k, k);
+      for (int j = 0; j < C; j++) {
+        a(k, j) /= pivot;
+        inv(k, j) /= pivot;
+      }
+      for (int i = 0; i < R; i++) {
+        if (i == k) continue;
+        const T l = a(i, k);
+        for (int j = 0; j < C; j++) {
+          a(i, j) -= l * a(k, j);
+          inv(i, j) -= l * inv(k, j);
+        }
+      }
+    }
+    return inv;
+  }
+
+ public:
+  constexpr S21FixedMatrix() noexcept = default;
+
+  // Row-major list of elements, missing ones stay zero
+  constexpr S21FixedMatrix(std::initializer_list<T> values) {
+    if (values.size() > matrix_.size())
+      throw std::out_of_range("Incorrect input, too many elements");
+    std::size_t k = 0;
+    for (const T &value : values) matrix_[k++] = value;
+  }
+
+  explicit S21FixedMatrix(const S21BasicMatrix<T> &other) {
+    if (other.getRows() != R || other.getCols() != C)
+      throw std::out_of_range(
+          "Incorrect input, matrices should have the same size");
+    for (int i = 0; i < R; i++)
+      for (int j = 0; j < C; j++) (*this)(i, j) = other(i, j);
+  }
+
+  [[nodiscard]] static constexpr S21FixedMatrix Identity() noexcept {
+    static_assert(R == C, "Identity matrix should be square");
+    S21FixedMatrix sol;
+    for (int i = 0; i < R; i++) sol(i, i) = T(1);
+    return sol;
+  }
+
+  [[nodiscard]] S21BasicMatrix<T> ToMatrix() const {
+    S21BasicMatrix<T> sol(R, C);
+    for (int i = 0; i < R; i++)
+      for (int j = 0; j < C; j++) sol(i, j) = (*this)(i, j);
+    return sol;
+  }
+  explicit operator S21BasicMatrix<T>() const { return ToMatrix(); }
+
+  [[nodiscard]] static constexpr int getRows() noexcept { return R; }
+  [[nodiscard]] static constexpr int getCols() noexcept { return C; }
+  [[nodiscard]] constexpr T *data() noexcept { return matrix_.data(); }
+  [[nodiscard]] constexpr const T *data() const noexcept {
+    return matrix_.data();
+  }
+
+  // Unchecked element access
+  constexpr T &operator()(int i, int j) noexcept { return matrix_[i * C + j]; }
+  constexpr const T &operator()(int i, int j) const noexcept {
+    return matrix_[i * C + j];
+  }
+
+  [[nodiscard]] constexpr bool EqMatrix(
+      const S21FixedMatrix &other) const noexcept {
+    for (std::size_t k = 0; k < matrix_.size(); k++)
+      if (abs_value(matrix_[k] - other.matrix_[k]) >= minimum_diff_)
+        return false;
+    return true;
+  }
+
+  constexpr void SumMatrix(const S21FixedMatrix &other) noexcept {
+    for (std::size_t k = 0; k < matrix_.size(); k++)
+      matrix_[k] += other.matrix_[k];
+  }
+
+  constexpr void SubMatrix(const S21FixedMatrix &other) noexcept {
+    for (std::size_t k = 0; k < matrix_.size(); k++)
+      matrix_[k] -= other.matrix_[k];
+  }
+
+  constexpr void MulNumber(const T num) noexcept {
+    for (T &value : matrix_) value *= num;
+  }
+
+  constexpr void MulMatrix(const S21FixedMatrix<T, C, C> &other) noexcept {
+    *this = *this * other;
+  }
+
+  [[nodiscard]] constexpr S21FixedMatrix<T, C, R> Transpose() const noexcept {
+    S21FixedMatrix<T, C, R> sol;
+    for (int i = 0; i < R; i++)
+      for (int j = 0; j < C; j++) sol(j, i) = (*this)(i, j);
+    return sol;
+  }
+
+  // Matrix without row m and column n
+  [[nodiscard]] constexpr S21FixedMatrix<T, R - 1, C - 1> Minor(
+      int m, int n) const noexcept {
+    S21FixedMatrix<T, R - 1, C - 1> sol;
+    for (int i = 0, si = 0; i < R; i++) {
+      if (i == m) continue;
+      for (int j = 0, sj = 0; j < C; j++) {
+        if (j == n) continue;
+        sol(si, sj++) = (*this)(i, j);
+      }
+      si++;
+    }
+    return sol;
+  }
+
+  [[nodiscard]] constexpr T Determinant() const noexcept {
+    static_assert(R == C, "Determinant needs a square matrix");
+    const auto &m = *this;
+    if constexpr (R == 1) {
+      return m(0, 0);
+    } else if constexpr (R == 2) {
+      return m(0, 0) * m(1, 1) - m(0, 1) * m(1, 0);
+    } else if constexpr (R == 3) {
+      return m(0, 0) * (m(1, 1) * m(2, 2) - m(1, 2) * m(2, 1)) -
+             m(0, 1) * (m(1, 0) * m(2, 2) - m(1, 2) * m(2, 0)) +
+             m(0, 2) * (m(1, 0) * m(2, 1) - m(1, 1) * m(2, 0));
+    } else if constexpr (R == 4) {
+      const T s0 = m(0, 0) * m(1, 1) - m(1, 0) * m(0, 1);
+      const T s1 = m(0, 0) * m(1, 2) - m(1, 0) * m(0, 2);
+      const T s2 = m(0, 0) * m(1, 3) - m(1, 0) * m(0, 3);
+      const T s3 = m(0, 1) * m(1, 2) - m(1, 1) * m(0, 2);
+      const T s4 = m(0, 1) * m(1, 3) - m(1, 1) * m(0, 3);
+      const T s5 = m(0, 2) * m(1, 3) - m(1, 2) * m(0, 3);
+      const T c5 = m(2, 2) * m(3, 3) - m(3, 2) * m(2, 3);
+      const T c4 = m(2, 1) * m(3, 3) - m(3, 1) * m(2, 3);
+      const T c3 = m(2, 1) * m(3, 2) - m(3, 1) * m(2, 2);
+      const T c2 = m(2, 0) * m(3, 3) - m(3, 0) * m(2, 3);
+      const T c1 = m(2, 0) * m(3, 2) - m(3, 0) * m(2, 2);
+      const T c0 = m(2, 0) * m(3, 1) - m(3, 0) * m(2, 1);
+      return s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0;
+    } else {
+      return determinant_elimination();
+    }
+  }
+
+  [[nodiscard]] constexpr S21FixedMatrix CalcComplements() const noexcept {
+    static_assert(R == C, "CalcComplements needs a square matrix");
+    S21FixedMatrix sol;
+    if constexpr (R == 1) {
+      sol(0, 0) = T(1);
+    } else {
+      for (int i = 0; i < R; i++)
+        for (int j = 0; j < C; j++)
+          sol(i, j) =
+              (((i + j) % 2) ? T(-1) : T(1)) * Minor(i, j).Determinant();
+    }
+    return sol;
+  }
+
+  [[nodiscard]] constexpr S21FixedMatrix InverseMatrix() const {
+    static_assert(R == C, "InverseMatrix needs a square matrix");
+    const auto &m = *this;
+    S21FixedMatrix sol;
+    if constexpr (R <= 3) {
+      const T det = Determinant();
+      if (singular_determinant(det))
+        throw std::out_of_range("Determinant = 0");
+      sol = CalcComplements().Transpose();
+      sol.MulNumber(T(1) / det);
+    } else if constexpr (R == 4) {
+      const T s0 = m(0, 0) * m(1, 1) - m(1, 0) * m(0, 1);
+      const T s1 = m(0, 0) * m(1, 2) - m(1, 0) * m(0, 2);
+      const T s2 = m(0, 0) * m(1, 3) - m(1, 0) * m(0, 3);
+      const T s3 = m(0, 1) * m(1, 2) - m(1, 1) * m(0, 2);
+      const T s4 = m(0, 1) * m(1, 3) - m(1, 1) * m(0, 3);
+      const T s5 = m(0, 2) * m(1, 3) - m(1, 2) * m(0, 3);
+      const T c5 = m(2, 2) * m(3, 3) - m(3, 2) * m(2, 3);
+      const T c4 = m(2, 1) * m(3, 3) - m(3, 1) * m(2, 3);
+      const T c3 = m(2, 1) * m(3, 2) - m(3, 1) * m(2, 2);
+      const T c2 = m(2, 0) * m(3, 3) - m(3, 0) * m(2, 3);
+      const T c1 = m(2, 0) * m(3, 2) - m(3, 0) * m(2, 2);
+      const T c0 = m(2, 0) * m(3, 1) - m(3, 0) * m(2, 1);
+      const T det = s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0;
+      if (singular_determinant(det))
+        throw std::out_of_range("Determinant = 0");
+      const T inv = T(1) / det;
+      sol(0, 0) = (m(1, 1) * c5 - m(1, 2) * c4 + m(1, 3) * c3) * inv;
+      sol(0, 1) = (-m(0, 1) * c5 + m(0, 2) * c4 - m(0, 3) * c3) * inv;
+      sol(0, 2) = (m(3, 1) * s5 - m(3, 2) * s4 + m(3, 3) * s3) * inv;
+      sol(0, 3) = (-m(2, 1) * s5 + m(2, 2) * s4 - m(2, 3) * s3) * inv;
+      sol(1, 0) = (-m(1, 0) * c5 + m(1, 2) * c2 - m(1, 3) * c1) * inv;
+      sol(1, 1) = (m(0, 0) * c5 - m(0, 2) * c2 + m(0, 3) * c1) * inv;
+      sol(1, 2) = (-m(3, 0) * s5 + m(3, 2) * s2 - m(3, 3) * s1) * inv;
+      sol(1, 3) = (m(2, 0) * s5 - m(2, 2) * s2 + m(2, 3) * s1) * inv;
+      sol(2, 0) = (m(1, 0) * c4 - m(1, 1) * c2 + m(1, 3) * c0) * inv;
+      sol(2, 1) = (-m(0, 0) * c4 + m(0, 1) * c2 - m(0, 3) * c0) * inv;
+      sol(2, 2) = (m(3, 0) * s4 - m(3, 1) * s2 + m(3, 3) * s0) * inv;
+      sol(2, 3) = (-m(2, 0) * s4 + m(2, 1) * s2 - m(2, 3) * s0) * inv;
+      sol(3, 0) = (-m(1, 0) * c3 + m(1, 1) * c1 - m(1, 2) * c0) * inv;
+      sol(3, 1) = (m(0, 0) * c3 - m(0, 1) * c1 + m(0, 2) * c0) * inv;
+      sol(3, 2) = (-m(3, 0) * s3 + m(3, 1) * s1 - m(3, 2) * s0) * inv;
+      sol(3, 3) = (m(2, 0) * s3 - m(2, 1) * s1 + m(2, 2) * s0) * inv;
+    } else {
+      sol = inverse_elimination();
+    }
+    return sol;
+  }
+
+  constexpr S21FixedMatrix operator+(const S21FixedMatrix &A) const noexcept {
+    S21FixedMatrix sol(*this);
+    sol.SumMatrix(A);
+    return sol;
+  }
+
+  constexpr S21FixedMatrix operator-(const S21FixedMatrix &A) const noexcept {
+    S21FixedMatrix sol(*this);
+    sol.SubMatrix(A);
+    return sol;
+  }
+
+  constexpr S21FixedMatrix operator*(const T number) const noexcept {
+    S21FixedMatrix sol(*this);
+    sol.MulNumber(number);
+    return sol;
+  }
+
+  template <int K>
+  constexpr S21FixedMatrix<T, R, K> operator*(
+      const S21FixedMatrix<T, C, K> &A) const noexcept {
+    S21FixedMatrix<T, R, K> sol;
+    for (int i = 0; i < R; i++)
+      for (int k = 0; k < C; k++) {
+        const T aik = (*this)(i, k);
+        for (int j = 0; j < K; j++) sol(i, j) += aik * A(k, j);
+      }
+    return sol;
+  }
+
+  constexpr bool operator==(const S21FixedMatrix &A) const noexcept {
+    return EqMatrix(A);
+  }
+  constexpr bool operator!=(const S21FixedMatrix &A) const noexcept {
+    return !EqMatrix(A);
+  }
+
+  constexpr S21FixedMatrix &operator+=(const S21FixedMatrix &A) noexcept {
+    SumMatrix(A);
+    return *this;
+  }
+  constexpr S21FixedMatrix &operator-=(const S21FixedMatrix &A) noexcept {
+    SubMatrix(A);
+    return *this;
+  }
+  constexpr S21FixedMatrix &operator*=(
+      const S21FixedMatrix<T, C, C> &A) noexcept {
+    MulMatrix(A);
+    return *this;
+  }
+  constexpr S21FixedMatrix &operator*=(const T number) noexcept {
+    MulNumber(number);
+    return *this;
+  }
+
+  friend constexpr S21FixedMatrix operator*(const T number,
+                                            const S21FixedMatrix &A) noexcept {
+    return A * number;
+  }
+};
+
+using S21Matrix2d = S21FixedMatrix<double, 2, 2>;
+using S21Matrix3d = S21FixedMatrix<double, 3, 3>;
+using S21Matrix4d = S21FixedMatrix<double, 4, 4>;
+
+#endif  // MATRIX_SRC_S21_FIXED_MATRIX_H
@@ -0,0 +1,71 @@
+// Compares the packed GEMM behind MulMatrix with the previous dot-product
+// implementation (one column walk per output element) and prints GFLOP/s.
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+#include "s21_matrix_oop.h"
+
+namespace {
+
+void randm(S21Matrix &m) {
+  for (int i = 0; i < m.getRows(); i++)
+    for (int j = 0; j < m.getCols(); j++) m(i, j) = rand() % 10;
+}
+
+// Reference: the former MulMatrix, c(i, j) = sum_k a(i, k) * b(k, j)
+S21Matrix naive_mul(const S21Matrix &a, const S21Matrix &b) {
+  S21Matrix c(a.getRows(), b.getCols());
+  const double *ad = a.data(), *bd = b.data();
+  double *cd = c.data();
+  for (int i = 0; i < c.getRows(); i++) {
+    for (int j = 0; j < c.getCols(); j++) {
+      double sol = 0;
+      for (int k = 0; k < a.getCols(); k++)
+        sol += ad[i * a.stride() + k] * bd[k * b.stride() + j];
+      cd[i * c.stride() + j] = sol;
+    }
+  }
+  return c;
+}
+
+// Runs fn until at least min_seconds elapsed, returns seconds per call
+template <typename F>
+double time_it(F fn, double min_seconds) {
+  using clock = std::chrono::steady_clock;
+  int runs = 0;
+  auto start = clock::now();
+  double elapsed = 0;
+  do {
+    fn();
+    runs++;
+    elapsed = std::chrono::duration<double>(clock::now() - start).count();
+  } while (elapsed < min_seconds);
+  return elapsed / runs;
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  const int naive_limit = argc > 1 ? std::atoi(argv[1]) : 1024;
+  std::printf("%6s %12s %12s %8s\n", "n", "naive GF/s", "gemm GF/s",
+              "speedup");
+  for (int n = 8; n <= 2048; n *= 2) {
+    S21Matrix a(n, n), b(n, n);
+    randm(a);
+    randm(b);
+    const double flops = 2.0 * n * n * n;
+    double t_gemm = time_it([&] { (void)(a * b); }, 0.2);
+    double gf_gemm = flops / t_gemm * 1e-9;
+    if (n <= naive_limit) {
+      double t_naive = time_it([&] { (void)naive_mul(a, b); }, 0.2);
+      double gf_naive = flops / t_naive * 1e-9;
+      std::printf("%6d %12.2f %12.2f %7.1fx\n", n, gf_naive, gf_gemm,
+                  gf_gemm / gf_naive);
+    } else {
+      std::printf("%6d %12s %12.2f %8s\n", n, "-", gf_gemm, "-");
+    }
+  }
+  return 0;
+}
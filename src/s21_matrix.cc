@@ -1,30 +1,74 @@
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <new>
+
+#include "s21_matrix_kernels.h"
 #include "s21_matrix_oop.h"
+#include "s21_matrix_stats.h"
+#include "s21_thread_pool.h"
 
 // Constructors
 
-S21Matrix::S21Matrix() noexcept : rows_(0), cols_(0), matrix_(nullptr) {}
-
-S21Matrix::S21Matrix(int rows, int cols) : rows_(rows), cols_(cols) {
+template <typename T>
+S21BasicMatrix<T>::S21BasicMatrix() noexcept
+    : S21BasicMatrix(static_cast<std::pmr::memory_resource *>(nullptr)) {}
+
+template <typename T>
+S21BasicMatrix<T>::S21BasicMatrix(std::pmr::memory_resource *resource) noexcept
+    : rows_(0),
+      cols_(0),
+      stride_(0),
+      row_capacity_(0),
+      matrix_(nullptr),
+      resource_(resource ? resource : S21CurrentResource()) {}
+
+template <typename T>
+S21BasicMatrix<T>::S21BasicMatrix(int rows, int cols,
+                                  std::pmr::memory_resource *resource)
+    : rows_(rows),
+      cols_(cols),
+      stride_(cols),
+      row_capacity_(rows),
+      matrix_(nullptr),
+      resource_(resource ? resource : S21CurrentResource()) {
   if (rows_ <= 0 || cols_ <= 0)
     throw std::out_of_range(
         "Incorrect input, rows and cols size should be positive");
-  matrix_ = new double *[rows_];
+  S21_STATS_COUNT(kConstruct);
   CreateMatrix();
 }
 
-S21Matrix::S21Matrix(const S21Matrix &other)
-    : rows_(other.rows_), cols_(other.cols_) {
+template <typename T>
+S21BasicMatrix<T>::S21BasicMatrix(const S21BasicMatrix &other)
+    : rows_(other.rows_),
+      cols_(other.cols_),
+      stride_(other.cols_),
+      row_capacity_(other.rows_),
+      matrix_(nullptr),
+      resource_(S21CurrentResource()) {
+  S21_STATS_SCOPE(kCopy, 0);
   CopyMatrix(other);
 }
 
-S21Matrix::S21Matrix(S21Matrix &&other) noexcept
-    : rows_(other.rows_), cols_(other.cols_), matrix_(other.matrix_) {
+template <typename T>
+S21BasicMatrix<T>::S21BasicMatrix(S21BasicMatrix &&other) noexcept
+    : rows_(other.rows_),
+      cols_(other.cols_),
+      stride_(other.stride_),
+      row_capacity_(other.row_capacity_),
+      matrix_(other.matrix_),
+      resource_(other.resource_) {
+  S21_STATS_COUNT(kMove);
   other.rows_ = 0;
   other.cols_ = 0;
+  other.stride_ = 0;
+  other.row_capacity_ = 0;
   other.matrix_ = nullptr;
 }
 
-S21Matrix::~S21Matrix() {
+template <typename T>
+S21BasicMatrix<T>::~S21BasicMatrix() {
   if (matrix_) {
     DeleteMatrix(*this);
   }
@@ -32,321 +76,508 @@ S21Matrix::~S21Matrix() {
 
 // accessors and mutators
 
-int S21Matrix::getRows() const noexcept { return rows_; }
+template <typename T>
+int S21BasicMatrix<T>::getRows() const noexcept { return rows_; }
 
-void S21Matrix::setRows(int input) {
+template <typename T>
+void S21BasicMatrix<T>::setRows(int input) {
   if (input <= 0)
     throw std::out_of_range("Incorrect input, size should be positive");
-  if (input != rows_) {
-    double **sol = new double *[input];
-    for (int i = 0; i < input; i++) {
-      sol[i] = new double[cols_];
-      for (int j = 0; j < cols_; j++) {
-        if (i < rows_) {
-          sol[i][j] = matrix_[i][j];
-        } else {
-          sol[i][j] = 0;
-        }
-      }
-    }
-    DeleteMatrix(*this);
-    rows_ = input;
-    matrix_ = sol;
+  if (input > row_capacity_) {
+    Reallocate(std::max(input, row_capacity_ + row_capacity_ / 2), stride_);
+  } else {
+    // rows past the old size may hold stale values from before a shrink
+    for (int i = rows_; i < input; i++)
+      std::fill_n(matrix_ + static_cast<std::size_t>(i) * stride_, cols_, T());
   }
+  rows_ = input;
 }
 
-int S21Matrix::getCols() const noexcept { return cols_; }
+template <typename T>
+int S21BasicMatrix<T>::getCols() const noexcept { return cols_; }
 
-void S21Matrix::setCols(int input) {
+template <typename T>
+void S21BasicMatrix<T>::setCols(int input) {
   if (input <= 0)
     throw std::out_of_range("Incorrect input, size should be positive");
-  if (input != cols_) {
-    double **sol = new double *[rows_];
-    for (int i = 0; i < rows_; i++) {
-      sol[i] = new double[input];
-      for (int j = 0; j < input; j++) {
-        if (j < cols_) {
-          sol[i][j] = matrix_[i][j];
-        } else {
-          sol[i][j] = 0;
-        }
-      }
-    }
+  if (input > stride_) {
+    Reallocate(row_capacity_, std::max(input, stride_ + stride_ / 2));
+  } else if (input > cols_) {
+    for (int i = 0; i < rows_; i++)
+      std::fill_n(matrix_ + static_cast<std::size_t>(i) * stride_ + cols_,
+                  input - cols_, T());
+  }
+  cols_ = input;
+}
+
+template <typename T>
+void S21BasicMatrix<T>::reserve(int rows, int cols) {
+  if (rows < 0 || cols < 0)
+    throw std::out_of_range("Incorrect input, size should not be negative");
+  if (rows > row_capacity_ || cols > stride_)
+    Reallocate(std::max(rows, row_capacity_), std::max(cols, stride_));
+}
+
+template <typename T>
+void S21BasicMatrix<T>::shrink_to_fit() {
+  if (row_capacity_ == rows_ && stride_ == cols_) return;
+  if (rows_ == 0 || cols_ == 0) {
     DeleteMatrix(*this);
-    cols_ = input;
-    matrix_ = sol;
+    row_capacity_ = rows_;
+    stride_ = cols_;
+  } else {
+    Reallocate(rows_, cols_);
   }
 }
 
 // private functions
 
-void S21Matrix::CreateMatrix() {
-  matrix_ = new double *[rows_]();
-  for (int i = 0; i < rows_; i++) {
-    try {
-      matrix_[i] = new double[cols_]();
-    } catch (...) {
-      for (int j = 0; j < i; j++) delete[] matrix_[j];
-      delete[] matrix_;
-      throw;
-    }
+// Size in bytes of a buffer of `count` items: rounded up to whole cache
+// lines, so that allocation and deallocation agree on it
+template <typename T>
+static std::size_t buffer_bytes(std::size_t count) noexcept {
+  constexpr std::size_t alignment = S21BasicMatrix<T>::kAlignment;
+  std::size_t bytes = std::max<std::size_t>(count * sizeof(T), 1);
+  return (bytes + alignment - 1) / alignment * alignment;
+}
+
+template <typename T>
+T *S21BasicMatrix<T>::AllocateBuffer(std::size_t count) const {
+  S21_STATS_BYTES(buffer_bytes<T>(count));
+  auto *buffer = static_cast<T *>(
+      resource_->allocate(buffer_bytes<T>(count), kAlignment));
+  std::uninitialized_fill_n(buffer, count, T());
+  return buffer;
+}
+
+template <typename T>
+void S21BasicMatrix<T>::FreeBuffer(T *buffer,
+                                   std::size_t count) const noexcept {
+  resource_->deallocate(buffer, buffer_bytes<T>(count), kAlignment);
+}
+
+template <typename T>
+void S21BasicMatrix<T>::CreateMatrix() {
+  matrix_ = AllocateBuffer(static_cast<std::size_t>(row_capacity_) * stride_);
+}
+
+// Moves the elements to a zeroed buffer of the given capacity
+template <typename T>
+void S21BasicMatrix<T>::Reallocate(int row_capacity, int stride) {
+  T *sol = AllocateBuffer(static_cast<std::size_t>(row_capacity) * stride);
+  const int rows = std::min(rows_, row_capacity);
+  const int cols = std::min(cols_, stride);
+  for (int i = 0; i < rows; i++) {
+    std::copy_n(matrix_ + static_cast<std::size_t>(i) * stride_, cols,
+                sol + static_cast<std::size_t>(i) * stride);
   }
+  DeleteMatrix(*this);
+  row_capacity_ = row_capacity;
+  stride_ = stride;
+  matrix_ = sol;
 }
 
-void S21Matrix::CopyMatrix(const S21Matrix &A) {
+template <typename T>
+void S21BasicMatrix<T>::CopyMatrix(const S21BasicMatrix &A) {
   rows_ = A.rows_;
   cols_ = A.cols_;
+  stride_ = A.cols_;
+  row_capacity_ = A.rows_;
+  if (!A.matrix_) {
+    matrix_ = nullptr;
+    return;
+  }
   CreateMatrix();
-  for (int i = 0; i < rows_; i++) {
-    for (int j = 0; j < cols_; j++) {
-      matrix_[i][j] = A.matrix_[i][j];
+  if (A.stride_ == stride_) {
+    std::copy_n(A.matrix_, static_cast<std::size_t>(rows_) * cols_, matrix_);
+  } else {
+    for (int i = 0; i < rows_; i++) {
+      std::copy_n(A.matrix_ + static_cast<std::size_t>(i) * A.stride_, cols_,
+                  matrix_ + static_cast<std::size_t>(i) * stride_);
     }
   }
 }
 
-void S21Matrix::DeleteMatrix(S21Matrix &A) noexcept {
-  for (int i = 0; i < A.rows_; i++) {
-    delete[] A.matrix_[i];
-  }
-  delete[] A.matrix_;
+template <typename T>
+void S21BasicMatrix<T>::DeleteMatrix(S21BasicMatrix &A) noexcept {
+  if (A.matrix_)
+    A.FreeBuffer(A.matrix_,
+                 static_cast<std::size_t>(A.row_capacity_) * A.stride_);
+  A.matrix_ = nullptr;
 }
 
-S21Matrix S21Matrix::minor(int m, int n) const {
+template <typename T>
+S21BasicMatrix<T> S21BasicMatrix<T>::minor(int m, int n) const {
+  S21_STATS_SCOPE(kMinor, 0);
   int flagi = 0, flagj = 0;
-  S21Matrix result(rows_ - 1, cols_ - 1);
+  S21BasicMatrix result(rows_ - 1, cols_ - 1);
   for (int i = 0; i < result.rows_; i++) {
     if (i == m) flagi = 1;
+    const T *src = matrix_ + static_cast<std::size_t>(i + flagi) * stride_;
+    T *dst = result.matrix_ + static_cast<std::size_t>(i) * result.stride_;
     for (int j = 0; j < result.cols_; j++) {
       if (j == n) flagj = 1;
-      result(i, j) = matrix_[i + flagi][j + flagj];
+      dst[j] = src[j + flagj];
     }
     flagj = 0;
   }
   return result;
 }
 
-bool S21Matrix::row_column_equal(const S21Matrix &A) const noexcept {
+template <typename T>
+bool S21BasicMatrix<T>::row_column_equal(
+    const S21BasicMatrix &A) const noexcept {
   return A.cols_ == cols_ && A.rows_ == rows_;
 }
 
-double S21Matrix::mnoj_matrix(const S21Matrix &A, int i, int j) const noexcept {
-  double sol = 0;
-  for (int k = 0; k < cols_; k++) {
-    sol += matrix_[i][k] * A.matrix_[k][j];
-  }
-  return sol;
-}
-
-double S21Matrix::determinant_out() const {
-  double result = 0;
-  if (rows_ == 1) {
-    result = matrix_[0][0];
-  } else {
-    for (int i = 0; i < rows_; i++) {
-      S21Matrix buff;
-      result +=
-          ((i % 2) ? -1 : 1) * matrix_[0][i] * minor(0, i).determinant_out();
-    }
-  }
-  return result;
-}
-
 // public functions
 
-bool S21Matrix::EqMatrix(const S21Matrix &other) const noexcept {
+template <typename T>
+bool S21BasicMatrix<T>::EqMatrix(const S21BasicMatrix &other) const noexcept {
   if (!row_column_equal(other)) return false;
-  for (int i = 0; i < rows_; i++) {
-    for (int j = 0; j < cols_; j++) {
-      if (std::abs(matrix_[i][j] - other.matrix_[i][j]) >= minimum_diff_) {
-        return false;
-      }
-    }
+  const long size = static_cast<long>(rows_) * cols_;
+  std::atomic<bool> equal(true);
+  if (stride_ == cols_ && other.stride_ == cols_) {
+    // chunks skip their work once another one found a difference
+    S21ThreadPool::ParallelFor(0, size, size, [&](long first, long last) {
+      if (equal && !s21::vec_equal(matrix_ + first, other.matrix_ + first,
+                                   last - first, minimum_diff_))
+        equal = false;
+    });
+    return equal;
   }
-  return true;
+  for (int i = 0; i < rows_ && equal; i++) {
+    const std::size_t row = i;
+    equal = s21::vec_equal(matrix_ + row * stride_,
+                           other.matrix_ + row * other.stride_, cols_,
+                           minimum_diff_);
+  }
+  return equal;
 }
 
-void S21Matrix::SumMatrix(const S21Matrix &other) {
+template <typename T>
+void S21BasicMatrix<T>::SumMatrix(const S21BasicMatrix &other) {
   if (!row_column_equal(other))
     throw std::out_of_range(
         "Incorrect input, matrices should have the same size");
-  for (int i = 0; i < rows_; i++) {
-    for (int j = 0; j < cols_; j++) {
-      matrix_[i][j] = matrix_[i][j] + other.matrix_[i][j];
-    }
+  const long size = static_cast<long>(rows_) * cols_;
+  S21_STATS_SCOPE(kSumMatrix, size);
+  if (stride_ == cols_ && other.stride_ == cols_) {
+    S21ThreadPool::ParallelFor(0, size, size, [&](long first, long last) {
+      s21::vec_add(matrix_ + first, other.matrix_ + first, last - first);
+    });
+  } else {
+    S21ThreadPool::ParallelFor(0, rows_, size, [&](long first, long last) {
+      for (long i = first; i < last; i++)
+        s21::vec_add(matrix_ + i * stride_, other.matrix_ + i * other.stride_,
+                     cols_);
+    });
   }
 }
 
-void S21Matrix::SubMatrix(const S21Matrix &other) {
+template <typename T>
+void S21BasicMatrix<T>::SubMatrix(const S21BasicMatrix &other) {
   if (!row_column_equal(other))
     throw std::out_of_range(
         "Incorrect input, matrices should have the same size");
-  for (int i = 0; i < rows_; i++) {
-    for (int j = 0; j < cols_; j++) {
-      matrix_[i][j] = matrix_[i][j] - other.matrix_[i][j];
-    }
+  const long size = static_cast<long>(rows_) * cols_;
+  S21_STATS_SCOPE(kSumMatrix, size);
+  if (stride_ == cols_ && other.stride_ == cols_) {
+    S21ThreadPool::ParallelFor(0, size, size, [&](long first, long last) {
+      s21::vec_sub(matrix_ + first, other.matrix_ + first, last - first);
+    });
+  } else {
+    S21ThreadPool::ParallelFor(0, rows_, size, [&](long first, long last) {
+      for (long i = first; i < last; i++)
+        s21::vec_sub(matrix_ + i * stride_, other.matrix_ + i * other.stride_,
+                     cols_);
+    });
   }
 }
 
-void S21Matrix::MulNumber(const double num) noexcept {
-  for (int i = 0; i < rows_; i++) {
-    for (int j = 0; j < cols_; j++) {
-      matrix_[i][j] = matrix_[i][j] * num;
-    }
+template <typename T>
+void S21BasicMatrix<T>::MulNumber(const T num) noexcept {
+  const long size = static_cast<long>(rows_) * cols_;
+  S21_STATS_SCOPE(kMulNumber, size);
+  if (stride_ == cols_) {
+    S21ThreadPool::ParallelFor(0, size, size, [&](long first, long last) {
+      s21::vec_scale(matrix_ + first, num, last - first);
+    });
+  } else {
+    S21ThreadPool::ParallelFor(0, rows_, size, [&](long first, long last) {
+      for (long i = first; i < last; i++)
+        s21::vec_scale(matrix_ + i * stride_, num, cols_);
+    });
   }
 }
 
-void S21Matrix::MulMatrix(const S21Matrix &other) noexcept {
+template <typename T>
+void S21BasicMatrix<T>::MulMatrix(const S21BasicMatrix &other) {
   if (other.rows_ != cols_)
     throw std::out_of_range(
         "Incorrect input, matrices should have the same size");
-  S21Matrix buff(rows_, other.cols_);
-  for (int i = 0; i < buff.rows_; i++) {
-    for (int j = 0; j < buff.cols_; j++) {
-      buff.matrix_[i][j] = mnoj_matrix(other, i, j);
-    }
+  Multiply(*this, *this, other);
+}
+
+template <typename T>
+void S21BasicMatrix<T>::Multiply(S21BasicMatrix &C, const S21BasicMatrix &A,
+                                 const S21BasicMatrix &B, T alpha, T beta,
+                                 S21Transpose trans_a, S21Transpose trans_b) {
+  const bool ta = trans_a == S21Transpose::kYes;
+  const bool tb = trans_b == S21Transpose::kYes;
+  const int m = ta ? A.cols_ : A.rows_;
+  const int k = ta ? A.rows_ : A.cols_;
+  const int n = tb ? B.rows_ : B.cols_;
+  if (!A.matrix_ || !B.matrix_ || (tb ? B.cols_ : B.rows_) != k)
+    throw std::out_of_range(
+        "Incorrect input, matrices should have the same size");
+  const bool shaped = C.matrix_ && C.rows_ == m && C.cols_ == n;
+  if (beta != T(0) && !shaped)
+    throw std::out_of_range(
+        "Incorrect input, accumulated matrix should have the product size");
+  S21_STATS_SCOPE(kMulMatrix, 2ULL * m * n * k);
+  if (&C == &A || &C == &B) {
+    // the kernel overwrites C while still reading the operands
+    S21BasicMatrix result(m, n, C.resource_);
+    if (beta != T(0)) result = C;
+    Multiply(result, A, B, alpha, beta, trans_a, trans_b);
+    C = std::move(result);
+    return;
   }
-  *this = std::move(buff);
+  if (!shaped) C = S21BasicMatrix(m, n, C.resource_);
+  // a transposed operand is the same buffer with its strides swapped
+  s21::gemm(m, n, k, alpha, A.matrix_, ta ? 1 : A.stride_, ta ? A.stride_ : 1,
+            B.matrix_, tb ? 1 : B.stride_, tb ? B.stride_ : 1, beta, C.matrix_,
+            C.stride_);
+}
+
+template <typename T>
+void S21BasicMatrix<T>::MultiplyStrassen(S21BasicMatrix &C,
+                                         const S21BasicMatrix &A,
+                                         const S21BasicMatrix &B,
+                                         int cutoff) {
+  if (!A.matrix_ || !B.matrix_ || A.cols_ != B.rows_)
+    throw std::out_of_range(
+        "Incorrect input, matrices should have the same size");
+  if (cutoff <= 0)
+    throw std::out_of_range("Incorrect input, cutoff should be positive");
+  const int m = A.rows_, n = B.cols_, k = A.cols_;
+  S21_STATS_SCOPE(kMulMatrix, 2ULL * m * n * k);
+  if (&C == &A || &C == &B || !C.matrix_ || C.rows_ != m || C.cols_ != n) {
+    S21BasicMatrix result(m, n, C.resource_);
+    s21::strassen(m, n, k, A.matrix_, A.stride_, B.matrix_, B.stride_,
+                  result.matrix_, result.stride_, cutoff);
+    C = std::move(result);
+    return;
+  }
+  s21::strassen(m, n, k, A.matrix_, A.stride_, B.matrix_, B.stride_,
+                C.matrix_, C.stride_, cutoff);
+}
+
+template <typename T>
+S21BasicMatrix<T> S21BasicMatrix<T>::Transpose() const {
+  S21_STATS_SCOPE(kTranspose, 0);
+  S21BasicMatrix sol(cols_, rows_);
+  // each chunk of source rows fills a band of destination columns
+  S21ThreadPool::ParallelFor(
+      0, rows_, static_cast<long>(rows_) * cols_, [&](long first, long last) {
+        s21::transpose(static_cast<int>(last - first), cols_,
+                       matrix_ + first * stride_, stride_, sol.matrix_ + first,
+                       sol.stride_);
+      });
+  return sol;
 }
 
-S21Matrix S21Matrix::Transpose() const {
-  S21Matrix sol(cols_, rows_);
-  for (int i = 0; i < rows_; i++) {
-    for (int j = 0; j < cols_; j++) {
-      sol.matrix_[j][i] = matrix_[i][j];
-    }
+template <typename T>
+void S21BasicMatrix<T>::TransposeInPlace() {
+  if (rows_ != cols_) {
+    *this = Transpose();
+    return;
   }
-  return sol;
+  S21_STATS_SCOPE(kTranspose, 0);
+  constexpr int block = s21::kTransposeBlock;
+  const int blocks = (rows_ + block - 1) / block;
+  // block row bi owns the pairs (bi, bj) with bj >= bi, so chunks of block
+  // rows never touch the same elements
+  S21ThreadPool::ParallelFor(
+      0, blocks, static_cast<long>(rows_) * cols_,
+      [&](long first, long last) {
+        for (long bi = first; bi < last; bi++) {
+          const int i = static_cast<int>(bi) * block;
+          const int rows = std::min(block, rows_ - i);
+          for (int j = i; j < cols_; j += block) {
+            const int cols = std::min(block, cols_ - j);
+            s21::transpose_swap(
+                rows, cols, matrix_ + static_cast<std::size_t>(i) * stride_ + j,
+                stride_, matrix_ + static_cast<std::size_t>(j) * stride_ + i,
+                stride_);
+          }
+        }
+      });
 }
 
-double S21Matrix::Determinant() const {
+template <typename T>
+T S21BasicMatrix<T>::Determinant() const {
   if (rows_ != cols_)
     throw std::out_of_range(
         "Incorrect input, matrices should have the same size");
-  return determinant_out();
+  S21_STATS_SCOPE(kDeterminant, 0);
+  return S21BasicLU<T>(*this).Determinant();
 }
 
-S21Matrix S21Matrix::CalcComplements() const {
-  S21Matrix buff(rows_, cols_);
+template <typename T>
+S21BasicMatrix<T> S21BasicMatrix<T>::CalcComplements() const {
   if (rows_ != cols_)
     throw std::out_of_range(
         "Incorrect input, matrices should have the same size");
-  for (int i = 0; i < rows_; i++) {
-    for (int j = 0; j < cols_; j++) {
-      buff(i, j) = (((i + j) % 2) ? -1 : 1) * minor(i, j).Determinant();
-    }
+  S21_STATS_SCOPE(kCalcComplements, 0);
+  if (rows_ == 1) {
+    S21BasicMatrix buff(1, 1);
+    buff.matrix_[0] = 1;
+    return buff;
   }
+  const S21BasicLU<T> lu(*this);
+  if (lu.IsInvertible()) {
+    S21BasicMatrix buff = lu.InverseMatrix();
+    buff.TransposeInPlace();
+    buff.MulNumber(lu.Determinant());
+    return buff;
+  }
+  // rank deficient: the n^2 minors are independent
+  S21BasicMatrix buff(rows_, cols_);
+  const long count = static_cast<long>(rows_) * cols_;
+  const long cost = count * rows_ * rows_ * rows_;
+  S21ThreadPool::ParallelFor(0, count, cost, [&](long first, long last) {
+    for (long k = first; k < last; k++) {
+      const int i = static_cast<int>(k / cols_);
+      const int j = static_cast<int>(k % cols_);
+      buff.matrix_[i * buff.stride_ + j] =
+          (((i + j) % 2) ? T(-1) : T(1)) *
+          S21BasicLU<T>(minor(i, j)).Determinant();
+    }
+  });
   return buff;
 }
 
-S21Matrix S21Matrix::InverseMatrix() const {
-  double det = Determinant();
-  if (std::abs(det) < minimum_diff_) throw std::out_of_range("Determinant = 0");
-  S21Matrix buff;
-  if (rows_ == 1 && cols_ == 1) {
-    S21Matrix buff(*this);
-  } else {
-    S21Matrix buff = Transpose().CalcComplements();
-  }
-  buff.MulNumber(1 / det);
-  return buff;
+template <typename T>
+S21BasicMatrix<T> S21BasicMatrix<T>::InverseMatrix() const {
+  S21_STATS_SCOPE(kInverseMatrix, 0);
+  return LU().InverseMatrix();
 }
 
-// overload
+template <typename T>
+S21BasicLU<T> S21BasicMatrix<T>::LU() const { return S21BasicLU<T>(*this); }
 
-S21Matrix S21Matrix::operator+(const S21Matrix &A) const {
-  S21Matrix sol(*this);
-  sol.SumMatrix(A);
-  return sol;
+template <typename T>
+S21BasicCholesky<T> S21BasicMatrix<T>::Cholesky() const {
+  return S21BasicCholesky<T>(*this);
 }
 
-S21Matrix S21Matrix::operator-(const S21Matrix &A) const {
-  S21Matrix sol(*this);
-  sol.SubMatrix(A);
-  return sol;
+template <typename T>
+S21BasicQR<T> S21BasicMatrix<T>::QR() const {
+  return S21BasicQR<T>(*this);
 }
 
-S21Matrix S21Matrix::operator*(const double number) const noexcept {
-  S21Matrix sol(*this);
-  sol.MulNumber(number);
-  return sol;
+template <typename T>
+S21BasicMatrix<T> S21BasicMatrix<T>::Solve(const S21BasicMatrix &b) const {
+  S21_STATS_SCOPE(kSolve, 0);
+  if (rows_ > cols_) return QR().Solve(b);
+  return LU().Solve(b);
 }
 
-S21Matrix S21Matrix::operator*(const S21Matrix &A) const {
-  S21Matrix sol(*this);
-  sol.MulMatrix(A);
+// overload
+
+template <typename T>
+S21BasicMatrix<T> S21BasicMatrix<T>::operator*(const S21BasicMatrix &A) const {
+  S21BasicMatrix sol;
+  Multiply(sol, *this, A);
   return sol;
 }
 
-bool S21Matrix::operator==(const S21Matrix &A) const noexcept {
+template <typename T>
+bool S21BasicMatrix<T>::operator==(const S21BasicMatrix &A) const noexcept {
   return EqMatrix(A);
 }
 
-bool S21Matrix::operator!=(const S21Matrix &A) const noexcept {
+template <typename T>
+bool S21BasicMatrix<T>::operator!=(const S21BasicMatrix &A) const noexcept {
   return !(EqMatrix(A));
 }
 
-S21Matrix &S21Matrix::operator=(S21Matrix &A) {
+template <typename T>
+S21BasicMatrix<T> &S21BasicMatrix<T>::operator=(const S21BasicMatrix &A) {
   if (this != &A) {
-    DeleteMatrix(*this);
-    rows_ = A.rows_;
-    cols_ = A.cols_;
-    CopyMatrix(A);
+    S21_STATS_SCOPE(kCopy, 0);
+    if (matrix_ && row_column_equal(A)) {
+      // same shape: reuse the buffer instead of reallocating
+      for (int i = 0; i < rows_; i++) {
+        const std::size_t row = i;
+        std::copy_n(A.matrix_ + row * A.stride_, cols_,
+                    matrix_ + row * stride_);
+      }
+    } else {
+      DeleteMatrix(*this);
+      CopyMatrix(A);
+    }
   }
   return *this;
 }
 
-S21Matrix &S21Matrix::operator=(S21Matrix &&A) noexcept {
-  if (this != &A) {
+template <typename T>
+S21BasicMatrix<T> &S21BasicMatrix<T>::operator=(S21BasicMatrix &&A) {
+  if (this != &A && !A.resource_->is_equal(*resource_)) {
+    // the buffer has to stay with the resource that owns this matrix
+    *this = static_cast<const S21BasicMatrix &>(A);
+  } else if (this != &A) {
+    S21_STATS_COUNT(kMove);
     DeleteMatrix(*this);
     rows_ = A.rows_;
     cols_ = A.cols_;
+    stride_ = A.stride_;
+    row_capacity_ = A.row_capacity_;
     matrix_ = A.matrix_;
 
     A.matrix_ = nullptr;
     A.rows_ = 0;
     A.cols_ = 0;
+    A.stride_ = 0;
+    A.row_capacity_ = 0;
   }
   return *this;
 }
 
-S21Matrix S21Matrix::operator+=(const S21Matrix &A) {
+template <typename T>
+S21BasicMatrix<T> S21BasicMatrix<T>::operator+=(const S21BasicMatrix &A) {
   SumMatrix(A);
   return *this;
 }
 
-S21Matrix S21Matrix::operator-=(const S21Matrix &A) {
+template <typename T>
+S21BasicMatrix<T> S21BasicMatrix<T>::operator-=(const S21BasicMatrix &A) {
   SubMatrix(A);
   return *this;
 }
 
-S21Matrix S21Matrix::operator*=(const S21Matrix &A) {
+template <typename T>
+S21BasicMatrix<T> S21BasicMatrix<T>::operator*=(const S21BasicMatrix &A) {
   MulMatrix(A);
   return *this;
 }
 
-S21Matrix S21Matrix::operator*=(const double number) noexcept {
+template <typename T>
+S21BasicMatrix<T> S21BasicMatrix<T>::operator*=(const T number) noexcept {
   MulNumber(number);
   return *this;
 }
 
-double &S21Matrix::operator()(int i, int j) {
-  if (i >= rows_ || j >= cols_)
-    throw std::out_of_range("Error! Value is out of range");
-  if (i < 0 || j < 0)
-    throw std::out_of_range("Error! Values should be positive");
-  return matrix_[i][j];
-}
-
-const double &S21Matrix::operator()(int i, int j) const {
-  if (i >= rows_ || j >= cols_)
-    throw std::out_of_range("Error! Value is out of range");
+template <typename T>
+void S21BasicMatrix<T>::throw_out_of_range(int i, int j) {
   if (i < 0 || j < 0)
     throw std::out_of_range("Error! Values should be positive");
-  return matrix_[i][j];
+  throw std::out_of_range("Error! Value is out of range");
 }
 
-S21Matrix operator*(const double num, const S21Matrix &A) noexcept {
-  S21Matrix sol(A);
-  sol.MulNumber(num);
-  return sol;
-}
+template class S21BasicMatrix<float>;
+template class S21BasicMatrix<double>;
+template class S21BasicMatrix<long double>;
+template class S21BasicMatrix<std::complex<double>>;
@@ -0,0 +1,804 @@
+// Google Benchmark suite for the public S21Matrix operations. Every
+// benchmark takes {rows, cols} arguments and sweeps square sizes plus a
+// few tall and wide shapes; `make bench` writes the results to bench.json.
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <utility>
+#include <vector>
+
+#include "s21_batch_matrix.h"
+#include "s21_matrix_eigen.h"
+#include "s21_matrix_io.h"
+#include "s21_matrix_oop.h"
+#include "s21_matrix_text.h"
+#include "s21_sparse_matrix.h"
+#include "s21_tiled_matrix.h"
+
+namespace {
+
+S21Matrix random_matrix(int rows, int cols, bool dominant = false) {
+  S21Matrix m(rows, cols);
+  for (int i = 0; i < rows; i++)
+    for (int j = 0; j < cols; j++) m(i, j) = rand() % 10 - 5;
+  // keeps square matrices well conditioned for the solvers
+  if (dominant)
+    for (int i = 0; i < rows && i < cols; i++) m(i, i) += 10 * cols;
+  return m;
+}
+
+// Square sizes from 4 to max_size plus tall, wide and thin shapes
+void shapes(benchmark::internal::Benchmark *b, int max_size) {
+  for (int n = 4; n <= max_size; n *= 4) b->Args({n, n});
+  if (max_size >= 256) {
+    b->Args({1024, 16});
+    b->Args({16, 1024});
+    b->Args({4096, 1});
+    b->Args({1, 4096});
+  }
+}
+
+void elementwise_shapes(benchmark::internal::Benchmark *b) {
+  shapes(b, 1024);
+}
+void cubic_shapes(benchmark::internal::Benchmark *b) {
+  for (int n = 4; n <= 512; n *= 2) b->Args({n, n});
+}
+void complements_shapes(benchmark::internal::Benchmark *b) {
+  for (int n = 2; n <= 32; n *= 2) b->Args({n, n});
+}
+
+void set_bytes(benchmark::State &state, long matrices) {
+  state.SetBytesProcessed(state.iterations() * matrices * state.range(0) *
+                          state.range(1) * static_cast<long>(sizeof(double)));
+}
+
+// Construction, copy and move
+
+void BM_Construct(benchmark::State &state) {
+  const int rows = state.range(0), cols = state.range(1);
+  for (auto _ : state) {
+    S21Matrix m(rows, cols);
+    benchmark::DoNotOptimize(m.data());
+  }
+  set_bytes(state, 1);
+}
+BENCHMARK(BM_Construct)->Apply(elementwise_shapes);
+
+void BM_Copy(benchmark::State &state) {
+  const S21Matrix source = random_matrix(state.range(0), state.range(1));
+  for (auto _ : state) {
+    S21Matrix m(source);
+    benchmark::DoNotOptimize(m.data());
+  }
+  set_bytes(state, 2);
+}
+BENCHMARK(BM_Copy)->Apply(elementwise_shapes);
+
+void BM_CopyAssign(benchmark::State &state) {
+  const S21Matrix source = random_matrix(state.range(0), state.range(1));
+  S21Matrix m(state.range(0), state.range(1));
+  for (auto _ : state) {
+    m = source;
+    benchmark::ClobberMemory();
+  }
+  set_bytes(state, 2);
+}
+BENCHMARK(BM_CopyAssign)->Apply(elementwise_shapes);
+
+void BM_Move(benchmark::State &state) {
+  S21Matrix a = random_matrix(state.range(0), state.range(1));
+  for (auto _ : state) {
+    S21Matrix b(std::move(a));
+    a = std::move(b);
+    benchmark::DoNotOptimize(a.data());
+  }
+}
+BENCHMARK(BM_Move)->Apply(elementwise_shapes);
+
+// Resizing: every iteration grows and shrinks back by one row or column
+
+void BM_SetRows(benchmark::State &state) {
+  const int rows = state.range(0);
+  S21Matrix m = random_matrix(rows, state.range(1));
+  for (auto _ : state) {
+    m.setRows(rows + 1);
+    m.setRows(rows);
+    benchmark::DoNotOptimize(m.data());
+  }
+  set_bytes(state, 2);
+}
+BENCHMARK(BM_SetRows)->Apply(elementwise_shapes);
+
+void BM_SetCols(benchmark::State &state) {
+  const int cols = state.range(1);
+  S21Matrix m = random_matrix(state.range(0), cols);
+  for (auto _ : state) {
+    m.setCols(cols + 1);
+    m.setCols(cols);
+    benchmark::DoNotOptimize(m.data());
+  }
+  set_bytes(state, 2);
+}
+BENCHMARK(BM_SetCols)->Apply(elementwise_shapes);
+
+// Streaming ingest: grows a matrix one row at a time up to state.range(0)
+void BM_AppendRows(benchmark::State &state) {
+  const int rows = state.range(0), cols = state.range(1);
+  for (auto _ : state) {
+    S21Matrix m(1, cols);
+    for (int i = 1; i < rows; i++) {
+      m.setRows(i + 1);
+      m(i, 0) = i;
+    }
+    benchmark::DoNotOptimize(m.data());
+  }
+  set_bytes(state, 1);
+}
+BENCHMARK(BM_AppendRows)->Args({1024, 16})->Args({4096, 64});
+
+// Element-wise arithmetic
+
+void BM_EqMatrix(benchmark::State &state) {
+  const S21Matrix a = random_matrix(state.range(0), state.range(1));
+  const S21Matrix b(a);
+  for (auto _ : state) benchmark::DoNotOptimize(a.EqMatrix(b));
+  set_bytes(state, 2);
+}
+BENCHMARK(BM_EqMatrix)->Apply(elementwise_shapes);
+
+void BM_SumMatrix(benchmark::State &state) {
+  S21Matrix a = random_matrix(state.range(0), state.range(1));
+  const S21Matrix b = random_matrix(state.range(0), state.range(1));
+  for (auto _ : state) {
+    a.SumMatrix(b);
+    benchmark::ClobberMemory();
+  }
+  set_bytes(state, 3);
+}
+BENCHMARK(BM_SumMatrix)->Apply(elementwise_shapes);
+
+void BM_SubMatrix(benchmark::State &state) {
+  S21Matrix a = random_matrix(state.range(0), state.range(1));
+  const S21Matrix b = random_matrix(state.range(0), state.range(1));
+  for (auto _ : state) {
+    a.SubMatrix(b);
+    benchmark::ClobberMemory();
+  }
+  set_bytes(state, 3);
+}
+BENCHMARK(BM_SubMatrix)->Apply(elementwise_shapes);
+
+void BM_MulNumber(benchmark::State &state) {
+  S21Matrix a = random_matrix(state.range(0), state.range(1));
+  for (auto _ : state) {
+    a.MulNumber(1.0000001);
+    benchmark::ClobberMemory();
+  }
+  set_bytes(state, 2);
+}
+BENCHMARK(BM_MulNumber)->Apply(elementwise_shapes);
+
+void BM_SumOperator(benchmark::State &state) {
+  const S21Matrix a = random_matrix(state.range(0), state.range(1));
+  const S21Matrix b = random_matrix(state.range(0), state.range(1));
+  S21Matrix c(state.range(0), state.range(1));
+  for (auto _ : state) {
+    c = a + b * 2.0;
+    benchmark::ClobberMemory();
+  }
+  set_bytes(state, 3);
+}
+BENCHMARK(BM_SumOperator)->Apply(elementwise_shapes);
+
+// Multiplication: n x k times k x n, reported in FLOP/s
+
+void BM_MulMatrix(benchmark::State &state) {
+  const int rows = state.range(0), cols = state.range(1);
+  const S21Matrix a = random_matrix(rows, cols);
+  const S21Matrix b = random_matrix(cols, rows);
+  for (auto _ : state) {
+    S21Matrix c(a);
+    c.MulMatrix(b);
+    benchmark::DoNotOptimize(c.data());
+  }
+  state.counters["FLOPS"] = benchmark::Counter(
+      2.0 * rows * rows * cols * state.iterations(),
+      benchmark::Counter::kIsRate);
+}
+BENCHMARK(BM_MulMatrix)->Apply(cubic_shapes)->Args({512, 16})->Args({16, 512});
+
+void BM_MulOperator(benchmark::State &state) {
+  const int n = state.range(0);
+  const S21Matrix a = random_matrix(n, n);
+  const S21Matrix b = random_matrix(n, n);
+  for (auto _ : state) {
+    S21Matrix c = a * b;
+    benchmark::DoNotOptimize(c.data());
+  }
+  state.counters["FLOPS"] = benchmark::Counter(
+      2.0 * n * n * n * state.iterations(), benchmark::Counter::kIsRate);
+}
+BENCHMARK(BM_MulOperator)->Apply(cubic_shapes);
+
+// C = A^T * B into a preallocated C, A stored k x n
+void BM_MultiplyTransA(benchmark::State &state) {
+  const int n = state.range(0);
+  const S21Matrix a = random_matrix(n, n);
+  const S21Matrix b = random_matrix(n, n);
+  S21Matrix c(n, n);
+  for (auto _ : state) {
+    S21Matrix::Multiply(c, a, b, 1.0, 0.0, S21Transpose::kYes);
+    benchmark::ClobberMemory();
+  }
+  state.counters["FLOPS"] = benchmark::Counter(
+      2.0 * n * n * n * state.iterations(), benchmark::Counter::kIsRate);
+}
+BENCHMARK(BM_MultiplyTransA)->Apply(cubic_shapes);
+
+// Strassen-Winograd against the classic kernel, both into a preallocated
+// C: {n, cutoff}. FLOPS counts the classic 2 n^3 for both, so the rates
+// compare directly; rel_error is the largest deviation from the classic
+// product relative to its largest element, for inputs in [-1, 1].
+
+S21Matrix uniform_matrix(int n) {
+  S21Matrix m(n, n);
+  for (double &x : m) x = 2.0 * rand() / RAND_MAX - 1.0;
+  return m;
+}
+
+void BM_MultiplyClassic(benchmark::State &state) {
+  const int n = state.range(0);
+  const S21Matrix a = uniform_matrix(n), b = uniform_matrix(n);
+  S21Matrix c(n, n);
+  for (auto _ : state) {
+    S21Matrix::Multiply(c, a, b);
+    benchmark::ClobberMemory();
+  }
+  state.counters["FLOPS"] = benchmark::Counter(
+      2.0 * n * n * n * state.iterations(), benchmark::Counter::kIsRate);
+}
+BENCHMARK(BM_MultiplyClassic)
+    ->Arg(256)
+    ->Arg(512)
+    ->Arg(1024)
+    ->Arg(2048)
+    ->Unit(benchmark::kMillisecond);
+
+void BM_MultiplyStrassen(benchmark::State &state) {
+  const int n = state.range(0), cutoff = state.range(1);
+  const S21Matrix a = uniform_matrix(n), b = uniform_matrix(n);
+  S21Matrix c(n, n);
+  for (auto _ : state) {
+    S21Matrix::MultiplyStrassen(c, a, b, cutoff);
+    benchmark::ClobberMemory();
+  }
+  state.counters["FLOPS"] = benchmark::Counter(
+      2.0 * n * n * n * state.iterations(), benchmark::Counter::kIsRate);
+  const S21Matrix classic = a * b;
+  double error = 0, scale = 0;
+  for (int i = 0; i < n; i++) {
+    for (int j = 0; j < n; j++) {
+      error = std::max(error, std::abs(c(i, j) - classic(i, j)));
+      scale = std::max(scale, std::abs(classic(i, j)));
+    }
+  }
+  state.counters["rel_error"] = error / scale;
+}
+BENCHMARK(BM_MultiplyStrassen)
+    ->ArgsProduct({{256, 512, 1024, 2048}, {64, 128, 256, 512}})
+    ->Args({1000, 128})
+    ->Args({1537, 256})
+    ->Unit(benchmark::kMillisecond);
+
+void BM_Transpose(benchmark::State &state) {
+  const S21Matrix a = random_matrix(state.range(0), state.range(1));
+  for (auto _ : state) {
+    S21Matrix t = a.Transpose();
+    benchmark::DoNotOptimize(t.data());
+  }
+  set_bytes(state, 2);
+}
+BENCHMARK(BM_Transpose)->Apply(elementwise_shapes)->Args({2048, 2048});
+
+// Same allocation and traffic as BM_Transpose without the reordering, the
+// bandwidth a transpose can approach
+void BM_CopyBaseline(benchmark::State &state) {
+  const S21Matrix a = random_matrix(state.range(0), state.range(1));
+  for (auto _ : state) {
+    S21Matrix b(a);
+    benchmark::DoNotOptimize(b.data());
+  }
+  set_bytes(state, 2);
+}
+BENCHMARK(BM_CopyBaseline)->Args({1024, 1024})->Args({2048, 2048});
+
+void BM_TransposeInPlace(benchmark::State &state) {
+  S21Matrix a = random_matrix(state.range(0), state.range(1));
+  for (auto _ : state) {
+    a.TransposeInPlace();
+    benchmark::DoNotOptimize(a.data());
+  }
+  set_bytes(state, 2);
+}
+BENCHMARK(BM_TransposeInPlace)->Args({1024, 1024})->Args({2048, 2048});
+
+// Element access: checked operator(), at_unchecked, row spans and the
+// element iterator, each summing every element
+
+void BM_SumChecked(benchmark::State &state) {
+  const S21Matrix a = random_matrix(state.range(0), state.range(1));
+  for (auto _ : state) {
+    double sum = 0;
+    for (int i = 0; i < a.getRows(); i++)
+      for (int j = 0; j < a.getCols(); j++) sum += a(i, j);
+    benchmark::DoNotOptimize(sum);
+  }
+  set_bytes(state, 1);
+}
+BENCHMARK(BM_SumChecked)->Args({1024, 1024});
+
+void BM_SumUnchecked(benchmark::State &state) {
+  const S21Matrix a = random_matrix(state.range(0), state.range(1));
+  for (auto _ : state) {
+    double sum = 0;
+    for (int i = 0; i < a.getRows(); i++)
+      for (int j = 0; j < a.getCols(); j++) sum += a.at_unchecked(i, j);
+    benchmark::DoNotOptimize(sum);
+  }
+  set_bytes(state, 1);
+}
+BENCHMARK(BM_SumUnchecked)->Args({1024, 1024});
+
+void BM_SumRows(benchmark::State &state) {
+  const S21Matrix a = random_matrix(state.range(0), state.range(1));
+  for (auto _ : state) {
+    double sum = 0;
+    for (auto row : a.rows())
+      for (double x : row) sum += x;
+    benchmark::DoNotOptimize(sum);
+  }
+  set_bytes(state, 1);
+}
+BENCHMARK(BM_SumRows)->Args({1024, 1024});
+
+void BM_SumIterator(benchmark::State &state) {
+  const S21Matrix a = random_matrix(state.range(0), state.range(1));
+  for (auto _ : state) {
+    double sum = 0;
+    for (double x : a) sum += x;
+    benchmark::DoNotOptimize(sum);
+  }
+  set_bytes(state, 1);
+}
+BENCHMARK(BM_SumIterator)->Args({1024, 1024});
+
+// File I/O against the page cache: element-wise fill as the baseline, a
+// bulk load, and a mapping read once
+const char *const kBenchFile = "s21_matrix_bench.bin";
+
+void BM_FillElementwise(benchmark::State &state) {
+  const S21Matrix a = random_matrix(state.range(0), state.range(1));
+  for (auto _ : state) {
+    S21Matrix b(a.getRows(), a.getCols());
+    for (int i = 0; i < a.getRows(); i++)
+      for (int j = 0; j < a.getCols(); j++) b(i, j) = a(i, j);
+    benchmark::DoNotOptimize(b.data());
+  }
+  set_bytes(state, 1);
+}
+BENCHMARK(BM_FillElementwise)->Args({2048, 2048});
+
+void BM_LoadMatrix(benchmark::State &state) {
+  S21SaveMatrix(random_matrix(state.range(0), state.range(1)), kBenchFile);
+  for (auto _ : state) {
+    S21Matrix b = S21LoadMatrix<double>(kBenchFile);
+    benchmark::DoNotOptimize(b.data());
+  }
+  std::remove(kBenchFile);
+  set_bytes(state, 1);
+}
+BENCHMARK(BM_LoadMatrix)->Args({2048, 2048});
+
+void BM_MapMatrix(benchmark::State &state) {
+  S21SaveMatrix(random_matrix(state.range(0), state.range(1)), kBenchFile);
+  for (auto _ : state) {
+    S21MappedMatrix mapped(kBenchFile);
+    double sum = 0;
+    const double *p = mapped.data();
+    for (long k = 0; k < state.range(0) * state.range(1); k++) sum += p[k];
+    benchmark::DoNotOptimize(sum);
+  }
+  std::remove(kBenchFile);
+  set_bytes(state, 1);
+}
+BENCHMARK(BM_MapMatrix)->Args({2048, 2048});
+
+// Text throughput is counted in bytes of text; values with a full
+// mantissa, like the exports of other systems
+S21Matrix text_matrix(int rows, int cols) {
+  S21Matrix m(rows, cols);
+  for (int i = 0; i < rows; i++)
+    for (int j = 0; j < cols; j++) m(i, j) = (rand() - RAND_MAX / 2) / 7.0;
+  return m;
+}
+
+void BM_SaveText(benchmark::State &state) {
+  const S21Matrix a = text_matrix(state.range(0), state.range(1));
+  for (auto _ : state) S21SaveText(a, kBenchFile);
+  S21TextReader reader(kBenchFile);
+  state.SetBytesProcessed(state.iterations() * reader.FileSize());
+  std::remove(kBenchFile);
+}
+BENCHMARK(BM_SaveText)->Args({2048, 2048});
+
+void BM_LoadText(benchmark::State &state) {
+  S21SaveText(text_matrix(state.range(0), state.range(1)), kBenchFile);
+  for (auto _ : state) {
+    S21Matrix b = S21LoadText<double>(kBenchFile);
+    benchmark::DoNotOptimize(b.data());
+  }
+  S21TextReader reader(kBenchFile);
+  state.SetBytesProcessed(state.iterations() * reader.FileSize());
+  std::remove(kBenchFile);
+}
+BENCHMARK(BM_LoadText)->Args({2048, 2048});
+
+void BM_StreamText(benchmark::State &state) {
+  S21SaveText(text_matrix(state.range(0), state.range(1)), kBenchFile);
+  S21Matrix chunk;
+  for (auto _ : state) {
+    S21TextReader reader(kBenchFile);
+    while (reader.ReadRows(chunk, 256) > 0)
+      benchmark::DoNotOptimize(chunk.data());
+  }
+  S21TextReader reader(kBenchFile);
+  state.SetBytesProcessed(state.iterations() * reader.FileSize());
+  std::remove(kBenchFile);
+}
+BENCHMARK(BM_StreamText)->Args({2048, 2048});
+
+// Out-of-core product through a cache of one tile row plus two; the
+// in-memory MulMatrix of the same size is the reference
+void BM_TiledMultiply(benchmark::State &state) {
+  const int n = state.range(0), tile = state.range(1);
+  S21TiledMatrix a = S21TiledMatrix::FromMatrix(
+      "s21_bench_a.bin", random_matrix(n, n), tile, n / tile + 2);
+  S21TiledMatrix b = S21TiledMatrix::FromMatrix(
+      "s21_bench_b.bin", random_matrix(n, n), tile, n / tile + 2);
+  S21TiledMatrix c =
+      S21TiledMatrix::Create("s21_bench_c.bin", n, n, tile, n / tile + 2);
+  for (auto _ : state) S21TiledMatrix::Multiply(c, a, b);
+  state.counters["FLOPS"] = benchmark::Counter(
+      2.0 * n * n * n * state.iterations(), benchmark::Counter::kIsRate);
+  for (const char *path : {"s21_bench_a.bin", "s21_bench_b.bin",
+                           "s21_bench_c.bin"})
+    std::remove(path);
+}
+BENCHMARK(BM_TiledMultiply)->Args({1024, 256})->Unit(benchmark::kMillisecond);
+
+// Sparse products on n x n matrices with about 8 non-zeros per row
+
+S21SparseMatrix random_sparse(int n) {
+  std::vector<S21SparseTriplet<double>> triplets;
+  for (int i = 0; i < n; i++)
+    for (int e = 0; e < 8; e++) triplets.push_back({i, rand() % n, 1.0});
+  return S21SparseMatrix::FromTriplets(n, n, triplets);
+}
+
+void BM_SparseMulDense(benchmark::State &state) {
+  const int n = state.range(0);
+  const S21SparseMatrix a = random_sparse(n);
+  const S21Matrix b = random_matrix(n, 64);
+  for (auto _ : state) {
+    S21Matrix c = a * b;
+    benchmark::DoNotOptimize(c.data());
+  }
+  state.counters["FLOPS"] = benchmark::Counter(
+      2.0 * a.NonZeros() * 64 * state.iterations(),
+      benchmark::Counter::kIsRate);
+}
+BENCHMARK(BM_SparseMulDense)->Arg(1024)->Arg(16384);
+
+void BM_SparseMulSparse(benchmark::State &state) {
+  const int n = state.range(0);
+  const S21SparseMatrix a = random_sparse(n), b = random_sparse(n);
+  for (auto _ : state) {
+    S21SparseMatrix c = a * b;
+    benchmark::DoNotOptimize(c.NonZeros());
+  }
+}
+BENCHMARK(BM_SparseMulSparse)->Arg(1024)->Arg(16384);
+
+// Batches of 10000 small matrices: the SoA container against a loop over
+// separate matrices; range(0) is the matrix size
+
+constexpr int kBatch = 10000;
+
+S21BatchMatrix random_batch(int n) {
+  S21BatchMatrix batch(kBatch, n, n);
+  for (int b = 0; b < kBatch; b++) batch.Set(b, random_matrix(n, n, true));
+  return batch;
+}
+
+std::vector<S21Matrix> random_vector(int n) {
+  std::vector<S21Matrix> matrices;
+  for (int b = 0; b < kBatch; b++)
+    matrices.push_back(random_matrix(n, n, true));
+  return matrices;
+}
+
+void BM_BatchMul(benchmark::State &state) {
+  const S21BatchMatrix a = random_batch(state.range(0));
+  const S21BatchMatrix b = random_batch(state.range(0));
+  for (auto _ : state) benchmark::DoNotOptimize((a * b).data());
+  state.SetItemsProcessed(state.iterations() * kBatch);
+}
+BENCHMARK(BM_BatchMul)->Arg(4)->Arg(6);
+
+void BM_BatchMultiplyInto(benchmark::State &state) {
+  const S21BatchMatrix a = random_batch(state.range(0));
+  const S21BatchMatrix b = random_batch(state.range(0));
+  S21BatchMatrix c(kBatch, state.range(0), state.range(0));
+  for (auto _ : state) {
+    S21BatchMatrix::Multiply(c, a, b);
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * kBatch);
+}
+BENCHMARK(BM_BatchMultiplyInto)->Arg(4)->Arg(6);
+
+void BM_LoopMul(benchmark::State &state) {
+  const std::vector<S21Matrix> a = random_vector(state.range(0));
+  const std::vector<S21Matrix> b = random_vector(state.range(0));
+  for (auto _ : state)
+    for (int k = 0; k < kBatch; k++)
+      benchmark::DoNotOptimize((a[k] * b[k]).data());
+  state.SetItemsProcessed(state.iterations() * kBatch);
+}
+BENCHMARK(BM_LoopMul)->Arg(4)->Arg(6);
+
+void BM_BatchInverse(benchmark::State &state) {
+  const S21BatchMatrix a = random_batch(state.range(0));
+  for (auto _ : state) benchmark::DoNotOptimize(a.InverseMatrix().data());
+  state.SetItemsProcessed(state.iterations() * kBatch);
+}
+BENCHMARK(BM_BatchInverse)->Arg(4)->Arg(6);
+
+void BM_LoopInverse(benchmark::State &state) {
+  const std::vector<S21Matrix> a = random_vector(state.range(0));
+  for (auto _ : state)
+    for (int k = 0; k < kBatch; k++)
+      benchmark::DoNotOptimize(a[k].InverseMatrix().data());
+  state.SetItemsProcessed(state.iterations() * kBatch);
+}
+BENCHMARK(BM_LoopInverse)->Arg(4)->Arg(6);
+
+void BM_BatchDeterminant(benchmark::State &state) {
+  const S21BatchMatrix a = random_batch(state.range(0));
+  for (auto _ : state) benchmark::DoNotOptimize(a.Determinant().data());
+  state.SetItemsProcessed(state.iterations() * kBatch);
+}
+BENCHMARK(BM_BatchDeterminant)->Arg(4)->Arg(6);
+
+void BM_LoopDeterminant(benchmark::State &state) {
+  const std::vector<S21Matrix> a = random_vector(state.range(0));
+  for (auto _ : state)
+    for (int k = 0; k < kBatch; k++)
+      benchmark::DoNotOptimize(a[k].Determinant());
+  state.SetItemsProcessed(state.iterations() * kBatch);
+}
+BENCHMARK(BM_LoopDeterminant)->Arg(4)->Arg(6);
+
+// Square-only operations
+
+void BM_Determinant(benchmark::State &state) {
+  const S21Matrix a = random_matrix(state.range(0), state.range(1), true);
+  for (auto _ : state) benchmark::DoNotOptimize(a.Determinant());
+}
+BENCHMARK(BM_Determinant)->Apply(cubic_shapes);
+
+void BM_InverseMatrix(benchmark::State &state) {
+  const S21Matrix a = random_matrix(state.range(0), state.range(1), true);
+  for (auto _ : state) {
+    S21Matrix inverse = a.InverseMatrix();
+    benchmark::DoNotOptimize(inverse.data());
+  }
+}
+BENCHMARK(BM_InverseMatrix)->Apply(cubic_shapes);
+
+// Solving A * X = B, {n, right-hand sides}: through the inverse, with a
+// fresh factorization each time and with one kept across iterations
+
+void solve_shapes(benchmark::internal::Benchmark *b) {
+  for (int n : {16, 128, 512}) b->Args({n, 1})->Args({n, 16});
+}
+
+void BM_SolveByInverse(benchmark::State &state) {
+  const S21Matrix a = random_matrix(state.range(0), state.range(0), true);
+  const S21Matrix b = random_matrix(state.range(0), state.range(1));
+  for (auto _ : state) {
+    S21Matrix x = a.InverseMatrix() * b;
+    benchmark::DoNotOptimize(x.data());
+  }
+}
+BENCHMARK(BM_SolveByInverse)->Apply(solve_shapes);
+
+void BM_Solve(benchmark::State &state) {
+  const S21Matrix a = random_matrix(state.range(0), state.range(0), true);
+  const S21Matrix b = random_matrix(state.range(0), state.range(1));
+  for (auto _ : state) {
+    S21Matrix x = a.Solve(b);
+    benchmark::DoNotOptimize(x.data());
+  }
+}
+BENCHMARK(BM_Solve)->Apply(solve_shapes);
+
+void BM_SolveReusedLU(benchmark::State &state) {
+  const S21Matrix a = random_matrix(state.range(0), state.range(0), true);
+  const S21Matrix b = random_matrix(state.range(0), state.range(1));
+  const S21LU lu = a.LU();
+  for (auto _ : state) {
+    S21Matrix x = lu.Solve(b);
+    benchmark::DoNotOptimize(x.data());
+  }
+}
+BENCHMARK(BM_SolveReusedLU)->Apply(solve_shapes);
+
+void BM_SolveReusedCholesky(benchmark::State &state) {
+  const int n = state.range(0);
+  const S21Matrix g = random_matrix(n, n);
+  S21Matrix a;
+  S21Matrix::Multiply(a, g, g, 1.0, 0.0, S21Transpose::kYes);
+  for (int i = 0; i < n; i++) a(i, i) += n;
+  const S21Matrix b = random_matrix(n, state.range(1));
+  const S21Cholesky chol = a.Cholesky();
+  for (auto _ : state) {
+    S21Matrix x = chol.Solve(b);
+    benchmark::DoNotOptimize(x.data());
+  }
+}
+BENCHMARK(BM_SolveReusedCholesky)->Apply(solve_shapes);
+
+void BM_Factorize(benchmark::State &state) {
+  const int n = state.range(0);
+  const S21Matrix g = random_matrix(n, n);
+  S21Matrix a;
+  S21Matrix::Multiply(a, g, g, 1.0, 0.0, S21Transpose::kYes);
+  for (int i = 0; i < n; i++) a(i, i) += n;
+  for (auto _ : state) {
+    switch (state.range(1)) {
+      case 0:
+        benchmark::DoNotOptimize(a.LU().Factors().data());
+        break;
+      case 1:
+        benchmark::DoNotOptimize(a.Cholesky().Factors().data());
+        break;
+      default:
+        benchmark::DoNotOptimize(a.QR().Factors().data());
+    }
+  }
+  state.SetLabel(state.range(1) == 0   ? "lu"
+                 : state.range(1) == 1 ? "cholesky"
+                                       : "qr");
+}
+BENCHMARK(BM_Factorize)->ArgsProduct({{128, 512}, {0, 1, 2}});
+
+void BM_CalcComplements(benchmark::State &state) {
+  const S21Matrix a = random_matrix(state.range(0), state.range(1), true);
+  for (auto _ : state) {
+    S21Matrix complements = a.CalcComplements();
+    benchmark::DoNotOptimize(complements.data());
+  }
+}
+BENCHMARK(BM_CalcComplements)->Apply(cubic_shapes);
+
+// Singular input takes the fallback through every minor
+void BM_CalcComplementsSingular(benchmark::State &state) {
+  S21Matrix a = random_matrix(state.range(0), state.range(1), true);
+  for (int j = 0; j < state.range(1); j++) a(0, j) = 0;
+  for (auto _ : state) {
+    S21Matrix complements = a.CalcComplements();
+    benchmark::DoNotOptimize(complements.data());
+  }
+}
+BENCHMARK(BM_CalcComplementsSingular)->Apply(complements_shapes);
+
+// Spectral decompositions, {n, n}
+
+S21Matrix random_symmetric(int n) {
+  S21Matrix a = random_matrix(n, n);
+  for (int i = 0; i < n; i++)
+    for (int j = 0; j < i; j++) a(i, j) = a(j, i);
+  return a;
+}
+
+// Textbook cyclic Jacobi: rotates every off-diagonal pair to zero, sweep
+// after sweep, until the off-diagonal part is negligible
+void jacobi_eigen(S21Matrix &a, S21Matrix &v) {
+  const int n = a.getRows();
+  for (int i = 0; i < n; i++) v(i, i) = 1;
+  for (int sweep = 0; sweep < 50; sweep++) {
+    double off = 0, total = 0;
+    for (int i = 0; i < n; i++) {
+      for (int j = 0; j < n; j++) {
+        total += a(i, j) * a(i, j);
+        if (i != j) off += a(i, j) * a(i, j);
+      }
+    }
+    if (off <= 1e-30 * total) return;
+    for (int p = 0; p < n; p++) {
+      for (int q = p + 1; q < n; q++) {
+        if (a(p, q) == 0) continue;
+        const double theta = (a(q, q) - a(p, p)) / (2 * a(p, q));
+        const double t = std::copysign(1.0, theta) /
+                         (std::abs(theta) + std::sqrt(theta * theta + 1));
+        const double c = 1 / std::sqrt(t * t + 1), s = t * c;
+        for (int k = 0; k < n; k++) {
+          const double akp = a(k, p), akq = a(k, q);
+          a(k, p) = c * akp - s * akq;
+          a(k, q) = s * akp + c * akq;
+        }
+        for (int k = 0; k < n; k++) {
+          const double apk = a(p, k), aqk = a(q, k);
+          a(p, k) = c * apk - s * aqk;
+          a(q, k) = s * apk + c * aqk;
+        }
+        for (int k = 0; k < n; k++) {
+          const double vkp = v(k, p), vkq = v(k, q);
+          v(k, p) = c * vkp - s * vkq;
+          v(k, q) = s * vkp + c * vkq;
+        }
+      }
+    }
+  }
+}
+
+void BM_JacobiEigen(benchmark::State &state) {
+  const S21Matrix a = random_symmetric(state.range(0));
+  for (auto _ : state) {
+    S21Matrix work(a), v(a.getRows(), a.getRows());
+    jacobi_eigen(work, v);
+    benchmark::DoNotOptimize(v.data());
+  }
+}
+BENCHMARK(BM_JacobiEigen)->Args({64, 64})->Args({128, 128})->Args({256, 256});
+
+void BM_SymmetricEigen(benchmark::State &state) {
+  const S21Matrix a = random_symmetric(state.range(0));
+  for (auto _ : state) {
+    S21SymmetricEigen eig(a);
+    benchmark::DoNotOptimize(eig.Eigenvectors().data());
+  }
+}
+BENCHMARK(BM_SymmetricEigen)
+    ->Args({64, 64})
+    ->Args({128, 128})
+    ->Args({256, 256})
+    ->Args({512, 512});
+
+void BM_SymmetricEigenvalues(benchmark::State &state) {
+  const S21Matrix a = random_symmetric(state.range(0));
+  for (auto _ : state) {
+    S21SymmetricEigen eig(a, false);
+    benchmark::DoNotOptimize(eig.Eigenvalues().data());
+  }
+}
+BENCHMARK(BM_SymmetricEigenvalues)->Args({256, 256})->Args({512, 512});
+
+void BM_SVD(benchmark::State &state) {
+  const S21Matrix a = random_matrix(state.range(0), state.range(1));
+  for (auto _ : state) {
+    S21SVD svd(a);
+    benchmark::DoNotOptimize(svd.U().data());
+  }
+}
+BENCHMARK(BM_SVD)->Args({256, 256})->Args({1024, 64})->Args({512, 512});
+
+}  // namespace
+
+BENCHMARK_MAIN();
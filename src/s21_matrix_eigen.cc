@@ -0,0 +1,459 @@
+#include "s21_matrix_eigen.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "s21_matrix_kernels.h"
+#include "s21_thread_pool.h"
+
+namespace {
+
+// QL or QR sweeps allowed per eigenvalue or singular value
+constexpr int kMaxSweeps = 60;
+
+// (row x, row y) = (c * x + s * y, c * y - s * x) on the vector matrix
+template <typename T>
+struct Rotation {
+  int x, y;
+  T c, s;
+};
+
+// Applies the rotations in order, each column range on its own thread,
+// and empties the list
+template <typename T>
+void apply_rotations(S21BasicMatrix<T> &w, std::vector<Rotation<T>> &list) {
+  if (list.empty()) return;
+  const long cols = w.getCols(), ld = w.stride();
+  T *data = w.data();
+  const long cost = 6L * cols * static_cast<long>(list.size());
+  S21ThreadPool::ParallelFor(0, cols, cost, [&](long j0, long j1) {
+    for (const Rotation<T> &r : list)
+      s21::vec_rot(data + r.x * ld + j0, data + r.y * ld + j0, r.c, r.s,
+                   j1 - j0);
+  });
+  list.clear();
+}
+
+// Reflector H = I - tau * v * v^T with v = (1, x / (alpha - beta)) that
+// maps (alpha, x) onto (beta, 0). The n elements of x, `inc` apart, are
+// overwritten with the tail of v; beta is returned.
+template <typename T>
+T make_reflector(T alpha, T *x, int n, long inc, T &tau) noexcept {
+  T norm = 0;
+  for (int i = 0; i < n; i++) norm += x[i * inc] * x[i * inc];
+  if (norm == 0) {
+    tau = 0;
+    return alpha;
+  }
+  const T beta = -std::copysign(std::sqrt(alpha * alpha + norm), alpha);
+  tau = (beta - alpha) / beta;
+  const T scale = 1 / (alpha - beta);
+  for (int i = 0; i < n; i++) x[i * inc] *= scale;
+  return beta;
+}
+
+// y[0:len, j0:j1] = H * y[0:len, j0:j1] for the reflector whose tail v
+// holds len - 1 elements `inc` apart, row by row over contiguous memory
+template <typename T>
+void reflect_rows(const T *v, long inc, int len, T tau, T *y, long ldy,
+                  long j0, long j1) {
+  const long cols = j1 - j0;
+  std::vector<T> w(y + j0, y + j1);
+  for (int i = 1; i < len; i++) {
+    const T vi = v[(i - 1) * inc];
+    if (vi != 0) s21::vec_axpy(w.data(), vi, y + i * ldy + j0, cols);
+  }
+  s21::vec_axpy(y + j0, -tau, w.data(), cols);
+  for (int i = 1; i < len; i++) {
+    const T vi = v[(i - 1) * inc];
+    if (vi != 0) s21::vec_axpy(y + i * ldy + j0, -tau * vi, w.data(), cols);
+  }
+}
+
+// q = H_0 * ... * H_(count-1) applied to the first q.getCols() columns of
+// the identity, where H_k acts on rows k + shift and below and its tail
+// starts at v(k). Built from the last reflector so that each one only
+// meets the columns it changes.
+template <typename T, typename Tail>
+void form_q(S21BasicMatrix<T> &q, int count, int shift, const T *tau,
+            Tail v, long inc) {
+  const int m = q.getRows(), n = q.getCols();
+  const long ld = q.stride();
+  T *data = q.data();
+  for (int i = 0; i < n; i++) data[i * ld + i] = 1;
+  for (int k = count - 1; k >= 0; k--) {
+    if (tau[k] == 0) continue;
+    const int first = k + shift;
+    const long cost = 4L * (m - first) * (n - first);
+    S21ThreadPool::ParallelFor(first, n, cost, [&](long j0, long j1) {
+      reflect_rows(v(k), inc, m - first, tau[k], data + first * ld, ld, j0,
+                   j1);
+    });
+  }
+}
+
+// Q^T * A * Q = T for the symmetric n x n matrix in a, both triangles
+// stored, with Q = H_0 * ... * H_(n-3). T's diagonal goes to d and its
+// off-diagonal to e; the tail of H_k is left in row k right of e[k].
+template <typename T>
+void tridiagonalize(T *a, long ld, int n, T *d, T *e, T *tau) {
+  std::vector<T> v(n), p(n);
+  for (int k = 0; k + 2 < n; k++) {
+    T *row = a + k * ld;
+    const int len = n - k - 1;
+    d[k] = row[k];
+    e[k] = make_reflector(row[k + 1], row + k + 2, len - 1, 1, tau[k]);
+    const T t = tau[k];
+    if (t == 0) continue;
+    v[0] = 1;
+    std::copy_n(row + k + 2, len - 1, v.begin() + 1);
+    T *b = a + (k + 1) * ld + (k + 1);
+    // p = tau * B * v, as a sum of B's rows since B is symmetric
+    const long cost = 2L * len * len;
+    S21ThreadPool::ParallelFor(0, len, cost, [&](long j0, long j1) {
+      std::fill(p.begin() + j0, p.begin() + j1, T(0));
+      for (int i = 0; i < len; i++) {
+        if (v[i] != 0)
+          s21::vec_axpy(p.data() + j0, v[i], b + i * ld + j0, j1 - j0);
+      }
+    });
+    T pv = 0;
+    for (int i = 0; i < len; i++) pv += p[i] * v[i];
+    // B = H * B * H = B - v * w^T - w * v^T, w = p - (tau / 2) (p.v) v
+    s21::vec_scale(p.data(), t, len);
+    s21::vec_axpy(p.data(), -t * t * pv / 2, v.data(), len);
+    S21ThreadPool::ParallelFor(0, len, 2 * cost, [&](long i0, long i1) {
+      for (long i = i0; i < i1; i++) {
+        s21::vec_axpy(b + i * ld, -v[i], p.data(), len);
+        s21::vec_axpy(b + i * ld, -p[i], v.data(), len);
+      }
+    });
+  }
+  if (n >= 2) {
+    d[n - 2] = a[(n - 2) * ld + n - 2];
+    e[n - 2] = a[(n - 2) * ld + n - 1];
+  }
+  d[n - 1] = a[(n - 1) * ld + n - 1];
+  e[n - 1] = 0;
+}
+
+// Implicit QL with Wilkinson shifts on the symmetric tridiagonal (d, e),
+// where e[i] couples i and i + 1. Rotations go to the rows of w.
+template <typename T>
+void tridiagonal_ql(T *d, T *e, int n, S21BasicMatrix<T> *w) {
+  const T eps = std::numeric_limits<T>::epsilon();
+  std::vector<Rotation<T>> list;
+  for (int l = 0; l < n; l++) {
+    for (int sweep = 0;; sweep++) {
+      int m = l;
+      for (; m < n - 1; m++)
+        if (std::abs(e[m]) <= eps * (std::abs(d[m]) + std::abs(d[m + 1])))
+          break;
+      if (m == l) break;
+      if (sweep == kMaxSweeps)
+        throw std::runtime_error("Eigenvalues did not converge");
+      T g = (d[l + 1] - d[l]) / (2 * e[l]);
+      T r = std::hypot(g, T(1));
+      g = d[m] - d[l] + e[l] / (g + std::copysign(r, g));
+      T s = 1, c = 1, p = 0;
+      int i = m - 1;
+      for (; i >= l; i--) {
+        const T f = s * e[i], b = c * e[i];
+        r = std::hypot(f, g);
+        e[i + 1] = r;
+        if (r == 0) {
+          // underflow: the matrix splits here
+          d[i + 1] -= p;
+          e[m] = 0;
+          break;
+        }
+        s = f / r;
+        c = g / r;
+        g = d[i + 1] - p;
+        r = (d[i] - g) * s + 2 * c * b;
+        p = s * r;
+        d[i + 1] = g + p;
+        g = c * r - b;
+        if (w) list.push_back({i + 1, i, c, s});
+      }
+      if (w) apply_rotations(*w, list);
+      if (r == 0 && i >= l) continue;
+      d[l] -= p;
+      e[l] = g;
+      e[m] = 0;
+    }
+  }
+}
+
+// U^T * A * V = B for the m x n matrix in a, m >= n, with B upper
+// bidiagonal: d on the diagonal, f[i] = B(i - 1, i) above it and f[0] = 0.
+// The tails of the left reflectors stay below the diagonal, those of the
+// right ones in row k right of the superdiagonal.
+template <typename T>
+void bidiagonalize(T *a, long ld, int m, int n, T *d, T *f, T *tau_u,
+                   T *tau_v) {
+  f[0] = 0;
+  for (int k = 0; k < n; k++) {
+    T *row = a + k * ld;
+    d[k] = make_reflector(row[k], row + ld + k, m - k - 1, ld, tau_u[k]);
+    row[k] = d[k];
+    const T tu = tau_u[k];
+    if (tu != 0 && k + 1 < n) {
+      const long cost = 4L * (m - k) * (n - k - 1);
+      S21ThreadPool::ParallelFor(k + 1, n, cost, [&](long j0, long j1) {
+        reflect_rows(row + ld + k, ld, m - k, tu, row, ld, j0, j1);
+      });
+    }
+    if (k + 1 == n) break;
+    f[k + 1] = make_reflector(row[k + 1], row + k + 2, n - k - 2, 1, tau_v[k]);
+    row[k + 1] = f[k + 1];
+    const T tv = tau_v[k];
+    if (tv == 0) continue;
+    // rows below times H, one row at a time
+    const T *v = row + k + 2;
+    const int len = n - k - 2;
+    const long cost = 4L * (m - k - 1) * (n - k - 1);
+    S21ThreadPool::ParallelFor(k + 1, m, cost, [&](long i0, long i1) {
+      for (long i = i0; i < i1; i++) {
+        T *ri = a + i * ld + k + 1;
+        T dot = ri[0];
+        for (int j = 0; j < len; j++) dot += ri[j + 1] * v[j];
+        ri[0] -= tv * dot;
+        s21::vec_axpy(ri + 1, -tv * dot, v, len);
+      }
+    });
+  }
+}
+
+// Golub-Kahan-Reinsch QR sweeps with implicit shifts on the bidiagonal
+// (d, f) of bidiagonalize(); left rotations go to the rows of ut and right
+// ones to the rows of vt. Leaves non-negative, unordered values in d.
+template <typename T>
+void bidiagonal_qr(T *d, T *f, int n, S21BasicMatrix<T> *ut,
+                   S21BasicMatrix<T> *vt) {
+  T norm = 0;
+  for (int i = 0; i < n; i++)
+    norm = std::max(norm, std::abs(d[i]) + std::abs(f[i]));
+  const T tol = std::numeric_limits<T>::epsilon() * norm;
+  std::vector<Rotation<T>> left, right;
+  auto flush = [&]() {
+    if (ut) apply_rotations(*ut, left);
+    if (vt) apply_rotations(*vt, right);
+  };
+  for (int k = n - 1; k >= 0; k--) {
+    for (int sweep = 0;; sweep++) {
+      // f[l] negligible splits the matrix; a negligible d[l - 1] is first
+      // made a split by rotating f[l] away from the left. f[0] is zero.
+      bool cancel = true;
+      int l = k;
+      for (; l >= 0; l--) {
+        if (std::abs(f[l]) <= tol) {
+          cancel = false;
+          break;
+        }
+        if (std::abs(d[l - 1]) <= tol) break;
+      }
+      if (cancel) {
+        T c = 0, s = 1;
+        for (int i = l; i <= k; i++) {
+          const T g = s * f[i];
+          f[i] *= c;
+          if (std::abs(g) <= tol) break;
+          const T h = std::hypot(g, d[i]);
+          c = d[i] / h;
+          s = -g / h;
+          d[i] = h;
+          if (ut) left.push_back({l - 1, i, c, s});
+        }
+      }
+      const T z = d[k];
+      if (l == k) {
+        if (z < 0) {
+          d[k] = -z;
+          if (vt) s21::vec_scale(vt->data() + k * vt->stride(), T(-1),
+                                 vt->getCols());
+        }
+        flush();
+        break;
+      }
+      if (sweep == kMaxSweeps)
+        throw std::runtime_error("Singular values did not converge");
+      // shift from the trailing 2 x 2 block
+      T x = d[l], y = d[k - 1], g = f[k - 1], h = f[k];
+      T a = ((y - z) * (y + z) + (g - h) * (g + h)) / (2 * h * y);
+      g = std::hypot(a, T(1));
+      a = ((x - z) * (x + z) + h * (y / (a + std::copysign(g, a)) - h)) / x;
+      // chase the bulge down
+      T c = 1, s = 1;
+      for (int j = l; j < k; j++) {
+        const int i = j + 1;
+        g = f[i];
+        y = d[i];
+        h = s * g;
+        g = c * g;
+        T r = std::hypot(a, h);
+        f[j] = r;
+        c = a / r;
+        s = h / r;
+        a = x * c + g * s;
+        g = g * c - x * s;
+        h = y * s;
+        y *= c;
+        if (vt) right.push_back({j, i, c, s});
+        r = std::hypot(a, h);
+        d[j] = r;
+        if (r != 0) {
+          c = a / r;
+          s = h / r;
+        }
+        a = c * g + s * y;
+        x = c * y - s * g;
+        if (ut) left.push_back({j, i, c, s});
+      }
+      f[l] = 0;
+      f[k] = a;
+      d[k] = x;
+      flush();
+    }
+  }
+}
+
+// Rows of w in the order given, transposed
+template <typename T>
+S21BasicMatrix<T> permuted_transpose(const S21BasicMatrix<T> &w,
+                                     const std::vector<int> &order) {
+  S21BasicMatrix<T> sorted(w.getRows(), w.getCols());
+  for (int i = 0; i < w.getRows(); i++)
+    std::copy_n(w.data() + order[i] * w.stride(), w.getCols(),
+                sorted.data() + i * sorted.stride());
+  if (sorted.getRows() != sorted.getCols()) return sorted.Transpose();
+  sorted.TransposeInPlace();
+  return sorted;
+}
+
+}  // namespace
+
+// Symmetric eigenproblem
+
+template <typename T>
+S21BasicSymmetricEigen<T>::S21BasicSymmetricEigen(const Matrix &A,
+                                                  bool vectors) {
+  if (A.getRows() != A.getCols())
+    throw std::out_of_range(
+        "Incorrect input, matrices should have the same size");
+  const int n = A.getRows();
+  Matrix a(A);
+  const long ld = a.stride();
+  T *data = a.data();
+  for (int i = 1; i < n; i++)
+    for (int j = 0; j < i; j++) data[i * ld + j] = data[j * ld + i];
+  std::vector<T> d(n), e(n), tau(n);
+  tridiagonalize(data, ld, n, d.data(), e.data(), tau.data());
+
+  Matrix w;
+  if (vectors) {
+    // rotations combine rows, so Q is kept transposed
+    w = Matrix(n, n);
+    form_q(w, n - 2, 1, tau.data(),
+           [&](int k) { return data + k * ld + k + 2; }, 1);
+    w.TransposeInPlace();
+  }
+  tridiagonal_ql(d.data(), e.data(), n, vectors ? &w : nullptr);
+
+  std::vector<int> order(n);
+  std::iota(order.begin(), order.end(), 0);
+  std::sort(order.begin(), order.end(),
+            [&](int i, int j) { return d[i] < d[j]; });
+  values_ = Matrix(n, 1);
+  for (int i = 0; i < n; i++) values_(i, 0) = d[order[i]];
+  if (vectors) vectors_ = permuted_transpose(w, order);
+}
+
+// Singular value decomposition
+
+template <typename T>
+S21BasicSVD<T>::S21BasicSVD(const Matrix &A, bool vectors)
+    : rows_(A.getRows()), cols_(A.getCols()) {
+  if (rows_ >= cols_) {
+    decompose(A, vectors);
+  } else {
+    // A^T = U * S * V^T
+    decompose(A.Transpose(), vectors);
+    std::swap(u_, v_);
+  }
+}
+
+template <typename T>
+void S21BasicSVD<T>::decompose(const Matrix &A, bool vectors) {
+  const int m = A.getRows(), n = A.getCols();
+  if (m >= 2 * n && n > 1) {
+    // the SVD of R, then U = Q * U_R
+    const S21BasicQR<T> qr(A);
+    decompose(qr.R(), vectors);
+    if (vectors) {
+      Matrix u;
+      Matrix::Multiply(u, qr.Q(), u_);
+      u_ = std::move(u);
+    }
+    return;
+  }
+  Matrix a(A);
+  const long ld = a.stride();
+  T *data = a.data();
+  std::vector<T> d(n), f(n), tau_u(n), tau_v(n);
+  bidiagonalize(data, ld, m, n, d.data(), f.data(), tau_u.data(),
+                tau_v.data());
+
+  Matrix ut, vt;
+  if (vectors) {
+    ut = Matrix(m, n);
+    form_q(ut, n, 0, tau_u.data(),
+           [&](int k) { return data + (k + 1) * ld + k; }, ld);
+    ut = ut.Transpose();
+    vt = Matrix(n, n);
+    form_q(vt, n - 1, 1, tau_v.data(),
+           [&](int k) { return data + k * ld + k + 2; }, 1);
+    vt.TransposeInPlace();
+  }
+  bidiagonal_qr(d.data(), f.data(), n, vectors ? &ut : nullptr,
+                vectors ? &vt : nullptr);
+
+  std::vector<int> order(n);
+  std::iota(order.begin(), order.end(), 0);
+  std::sort(order.begin(), order.end(),
+            [&](int i, int j) { return d[i] > d[j]; });
+  values_ = Matrix(n, 1);
+  for (int i = 0; i < n; i++) values_(i, 0) = d[order[i]];
+  if (vectors) {
+    u_ = permuted_transpose(ut, order);
+    v_ = permuted_transpose(vt, order);
+  }
+}
+
+template <typename T>
+T S21BasicSVD<T>::ConditionNumber() const noexcept {
+  const T smallest = values_(values_.getRows() - 1, 0);
+  if (smallest == 0) return std::numeric_limits<T>::infinity();
+  return values_(0, 0) / smallest;
+}
+
+template <typename T>
+int S21BasicSVD<T>::Rank() const noexcept {
+  const T tol = std::max(rows_, cols_) * std::numeric_limits<T>::epsilon() *
+                values_(0, 0);
+  int rank = 0;
+  while (rank < values_.getRows() && values_(rank, 0) > tol) rank++;
+  return rank;
+}
+
+template class S21BasicSymmetricEigen<float>;
+template class S21BasicSymmetricEigen<double>;
+template class S21BasicSymmetricEigen<long double>;
+template class S21BasicSVD<float>;
+template class S21BasicSVD<double>;
+template class S21BasicSVD<long double>;
@@ -0,0 +1,79 @@
+#ifndef MATRIX_SRC_S21_MATRIX_EIGEN_H
+#define MATRIX_SRC_S21_MATRIX_EIGEN_H
+
+#include "s21_matrix_oop.h"
+
+// Spectral decompositions of real matrices, instantiated for float, double
+// and long double. Both reduce the matrix with Householder reflectors, to
+// tridiagonal or bidiagonal form, then run implicitly shifted QL or QR
+// sweeps on the reduced matrix. The Givens rotations of a sweep are
+// recorded and applied to the vectors afterwards, in parallel over column
+// ranges of the row pairs they combine.
+//
+// Non-square input to the eigensolver throws std::out_of_range, sweeps that
+// fail to converge throw std::runtime_error.
+
+// A = V * diag(w) * V^T for a symmetric A, of which only the upper
+// triangle is read
+template <typename T>
+class S21BasicSymmetricEigen {
+ public:
+  using Matrix = S21BasicMatrix<T>;
+
+ private:
+  Matrix values_;   // n x 1, ascending
+  Matrix vectors_;  // Eigenvector i in column i, empty when not asked for
+
+ public:
+  explicit S21BasicSymmetricEigen(const Matrix &A, bool vectors = true);
+
+  [[nodiscard]] int size() const noexcept { return values_.getRows(); }
+  [[nodiscard]] const Matrix &Eigenvalues() const noexcept { return values_; }
+  [[nodiscard]] const Matrix &Eigenvectors() const noexcept {
+    return vectors_;
+  }
+};
+
+// Thin singular value decomposition A = U * diag(s) * V^T of an m x n
+// matrix, with U m x k, V n x k and k = min(m, n). A matrix with at least
+// twice as many rows as columns is first reduced to its n x n R factor by
+// S21BasicQR, and U is then multiplied back with Q.
+template <typename T>
+class S21BasicSVD {
+ public:
+  using Matrix = S21BasicMatrix<T>;
+
+ private:
+  int rows_, cols_;  // Shape of A
+  Matrix u_;
+  Matrix values_;    // k x 1, descending
+  Matrix v_;
+
+  void decompose(const Matrix &A, bool vectors);
+
+ public:
+  explicit S21BasicSVD(const Matrix &A, bool vectors = true);
+
+  // Left and right singular vectors, empty when not asked for
+  [[nodiscard]] const Matrix &U() const noexcept { return u_; }
+  [[nodiscard]] const Matrix &SingularValues() const noexcept {
+    return values_;
+  }
+  [[nodiscard]] const Matrix &V() const noexcept { return v_; }
+  // Largest over smallest singular value, infinity for a singular A
+  [[nodiscard]] T ConditionNumber() const noexcept;
+  // Singular values above max(m, n) * epsilon * largest
+  [[nodiscard]] int Rank() const noexcept;
+};
+
+using S21SymmetricEigen = S21BasicSymmetricEigen<double>;
+using S21SVD = S21BasicSVD<double>;
+
+extern template class S21BasicSymmetricEigen<float>;
+extern template class S21BasicSymmetricEigen<double>;
+extern template class S21BasicSymmetricEigen<long double>;
+extern template class S21BasicSVD<float>;
+extern template class S21BasicSVD<double>;
+extern template class S21BasicSVD<long double>;
+
+#endif  // MATRIX_SRC_S21_MATRIX_EIGEN_H
@@ -0,0 +1,125 @@
+#ifndef MATRIX_SRC_S21_MATRIX_EXPR_H
+#define MATRIX_SRC_S21_MATRIX_EXPR_H
+
+#include <stdexcept>
+#include <type_traits>
+
+// Expression templates for element-wise arithmetic. operator+, operator-
+// and multiplication by a number build a tree of lightweight nodes instead
+// of temporaries; assigning the tree to an S21Matrix evaluates every element
+// in one pass. Nodes keep references to the matrices they were built from,
+// so an expression must not outlive its operands (avoid `auto e = A + B;`).
+//
+// Every expression type E provides value_type, getRows(), getCols() and an
+// unchecked eval(i, j); kExprLeaf tells whether it is a stored matrix (kept
+// by reference inside a node) or a node (kept by value). aliases(data,
+// stride) tells whether evaluating element (i, j) may read an element other
+// than (i, j) of a getRows() x getCols() destination at data, so that
+// writing the result in place would read elements already overwritten.
+
+template <typename E>
+class S21MatrixExpr {
+ public:
+  [[nodiscard]] const E &self() const noexcept {
+    return static_cast<const E &>(*this);
+  }
+};
+
+template <typename E>
+using S21ExprOperand =
+    std::conditional_t<E::kExprLeaf, const E &, const E>;
+
+struct S21ExprPlus {
+  template <typename T>
+  static T apply(const T &a, const T &b) noexcept {
+    return a + b;
+  }
+};
+
+struct S21ExprMinus {
+  template <typename T>
+  static T apply(const T &a, const T &b) noexcept {
+    return a - b;
+  }
+};
+
+template <typename L, typename R, typename Op>
+class S21BinaryExpr : public S21MatrixExpr<S21BinaryExpr<L, R, Op>> {
+ private:
+  S21ExprOperand<L> left_;
+  S21ExprOperand<R> right_;
+
+ public:
+  using value_type = typename L::value_type;
+  static constexpr bool kExprLeaf = false;
+  static_assert(std::is_same_v<value_type, typename R::value_type>,
+                "Operands should have the same element type");
+
+  S21BinaryExpr(const L &left, const R &right) : left_(left), right_(right) {
+    if (left.getRows() != right.getRows() || left.getCols() != right.getCols())
+      throw std::out_of_range(
+          "Incorrect input, matrices should have the same size");
+  }
+
+  [[nodiscard]] int getRows() const noexcept { return left_.getRows(); }
+  [[nodiscard]] int getCols() const noexcept { return left_.getCols(); }
+  [[nodiscard]] value_type eval(int i, int j) const noexcept {
+    return Op::apply(left_.eval(i, j), right_.eval(i, j));
+  }
+  [[nodiscard]] bool aliases(const value_type *data,
+                             long stride) const noexcept {
+    return left_.aliases(data, stride) || right_.aliases(data, stride);
+  }
+};
+
+template <typename E>
+class S21ScaleExpr : public S21MatrixExpr<S21ScaleExpr<E>> {
+ public:
+  using value_type = typename E::value_type;
+
+ private:
+  S21ExprOperand<E> operand_;
+  value_type number_;
+
+ public:
+  static constexpr bool kExprLeaf = false;
+
+  S21ScaleExpr(const E &operand, value_type number) noexcept
+      : operand_(operand), number_(number) {}
+
+  [[nodiscard]] int getRows() const noexcept { return operand_.getRows(); }
+  [[nodiscard]] int getCols() const noexcept { return operand_.getCols(); }
+  [[nodiscard]] value_type eval(int i, int j) const noexcept {
+    return operand_.eval(i, j) * number_;
+  }
+  [[nodiscard]] bool aliases(const value_type *data,
+                             long stride) const noexcept {
+    return operand_.aliases(data, stride);
+  }
+};
+
+template <typename L, typename R>
+S21BinaryExpr<L, R, S21ExprPlus> operator+(const S21MatrixExpr<L> &left,
+                                           const S21MatrixExpr<R> &right) {
+  return {left.self(), right.self()};
+}
+
+template <typename L, typename R>
+S21BinaryExpr<L, R, S21ExprMinus> operator-(const S21MatrixExpr<L> &left,
+                                            const S21MatrixExpr<R> &right) {
+  return {left.self(), right.self()};
+}
+
+template <typename E>
+S21ScaleExpr<E> operator*(const S21MatrixExpr<E> &expr,
+                          const typename E::value_type number) noexcept {
+  return {expr.self(), number};
+}
+
+template <typename E>
+S21ScaleExpr<E> operator*(const typename E::value_type number,
+                          const S21MatrixExpr<E> &expr) noexcept {
+  return {expr.self(), number};
+}
+
+#endif  // MATRIX_SRC_S21_MATRIX_EXPR_H
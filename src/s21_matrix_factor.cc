@@ -0,0 +1,295 @@
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include "s21_matrix_oop.h"
+#include "s21_matrix_stats.h"
+#include "s21_thread_pool.h"
+
+namespace {
+
+template <typename T>
+T conjugate(T x) noexcept {
+  return x;
+}
+
+template <typename R>
+std::complex<R> conjugate(std::complex<R> x) noexcept {
+  return std::conj(x);
+}
+
+// Largest magnitude among the first `cols` elements of `rows` rows
+template <typename T, typename R = typename S21ScalarTraits<T>::real_type>
+R max_abs(const T *a, int ld, int rows, int cols) noexcept {
+  R scale = 0;
+  for (int i = 0; i < rows; i++)
+    for (int j = 0; j < cols; j++)
+      scale = std::max(scale, std::abs(a[i * ld + j]));
+  return scale;
+}
+
+// y[k:m, j0:j1] -= tau * v * (v^H * y[k:m, j0:j1]) for the reflector
+// v = (1, a[k + 1][k], ..., a[m - 1][k]), row by row so that both passes
+// run over contiguous memory
+template <typename T>
+void reflect(const T *a, int lda, int m, int k, T tau, T *y, int ldy,
+             long j0, long j1) {
+  std::vector<T> w(y + k * ldy + j0, y + k * ldy + j1);
+  for (int i = k + 1; i < m; i++) {
+    const T v = conjugate(a[i * lda + k]);
+    if (v == T(0)) continue;
+    const T *yi = y + i * ldy;
+    for (long j = j0; j < j1; j++) w[j - j0] += v * yi[j];
+  }
+  for (long j = j0; j < j1; j++) w[j - j0] *= tau;
+  T *yk = y + k * ldy;
+  for (long j = j0; j < j1; j++) yk[j] -= w[j - j0];
+  for (int i = k + 1; i < m; i++) {
+    const T v = a[i * lda + k];
+    if (v == T(0)) continue;
+    T *yi = y + i * ldy;
+    for (long j = j0; j < j1; j++) yi[j] -= v * w[j - j0];
+  }
+}
+
+// Rows of b in a new matrix of the same shape
+template <typename T>
+S21BasicMatrix<T> copy_rows(const S21BasicMatrix<T> &b, int rows) {
+  S21BasicMatrix<T> x(rows, b.getCols());
+  for (int i = 0; i < rows; i++)
+    std::copy_n(b.data() + i * b.stride(), b.getCols(),
+                x.data() + i * x.stride());
+  return x;
+}
+
+// x[:, j0:j1] = U^-1 * x[:, j0:j1] for the upper triangle U of u
+template <typename T>
+void back_substitute(const T *u, int ldu, int n, T *x, int ldx, long j0,
+                     long j1) noexcept {
+  for (int i = n - 1; i >= 0; i--) {
+    T *xi = x + i * ldx;
+    for (int k = i + 1; k < n; k++) {
+      const T a = u[i * ldu + k];
+      if (a == T(0)) continue;
+      const T *xk = x + k * ldx;
+      for (long j = j0; j < j1; j++) xi[j] -= a * xk[j];
+    }
+    const T inv = T(1) / u[i * ldu + i];
+    for (long j = j0; j < j1; j++) xi[j] *= inv;
+  }
+}
+
+}  // namespace
+
+// Cholesky
+
+// Right-looking like LU: row k of U is scaled, then the trailing upper
+// triangle is updated row by row over contiguous memory.
+template <typename T>
+S21BasicCholesky<T>::S21BasicCholesky(const Matrix &A)
+    : S21BasicCholesky(Matrix(A)) {}
+
+template <typename T>
+S21BasicCholesky<T>::S21BasicCholesky(Matrix &&A)
+    : u_(std::move(A)), positive_definite_(true) {
+  if (u_.getRows() != u_.getCols())
+    throw std::out_of_range(
+        "Incorrect input, matrices should have the same size");
+  const int n = u_.getRows();
+  S21_STATS_SCOPE(kCholesky, 1ULL * n * n * n / 3);
+  const int ld = u_.stride();
+  T *a = u_.data();
+  // pivots below round-off level of the input are treated as exact zeros
+  const real_type tiny =
+      n * std::numeric_limits<real_type>::epsilon() * max_abs(a, ld, n, n);
+
+  for (int k = 0; k < n; k++) {
+    T *row_k = a + k * ld;
+    const real_type d = std::real(row_k[k]);
+    if (!(d > tiny)) {
+      positive_definite_ = false;
+      return;
+    }
+    const real_type r = std::sqrt(d);
+    row_k[k] = r;
+    const T inv = T(1 / r);
+    for (int j = k + 1; j < n; j++) row_k[j] *= inv;
+    const long rest = n - k - 1;
+    S21ThreadPool::ParallelFor(
+        k + 1, n, rest * rest / 2, [=](long first, long last) {
+          for (long i = first; i < last; i++) {
+            const T l = conjugate(row_k[i]);
+            if (l == T(0)) continue;
+            T *row_i = a + i * ld;
+            for (int j = i; j < n; j++) row_i[j] -= l * row_k[j];
+          }
+        });
+  }
+}
+
+template <typename T>
+T S21BasicCholesky<T>::Determinant() const noexcept {
+  if (!positive_definite_) return T(0);
+  const int n = size();
+  const int ld = u_.stride();
+  const T *a = u_.data();
+  T det = T(1);
+  for (int i = 0; i < n; i++) det *= a[i * ld + i] * a[i * ld + i];
+  return det;
+}
+
+template <typename T>
+S21BasicMatrix<T> S21BasicCholesky<T>::Solve(const Matrix &b) const {
+  const int n = size();
+  if (b.getRows() != n)
+    throw std::out_of_range(
+        "Incorrect input, right-hand side should have as many rows as A");
+  if (!positive_definite_)
+    throw std::out_of_range("Matrix is not positive definite");
+
+  const int m = b.getCols();
+  S21_STATS_SCOPE(kSolve, 2ULL * n * n * m);
+  Matrix x = copy_rows(b, n);
+  const int ldx = x.stride();
+  T *xd = x.data();
+  const int ld = u_.stride();
+  const T *a = u_.data();
+  auto substitute = [&](long j0, long j1) {
+    // U^H * y = b, spreading each solved row down
+    for (int k = 0; k < n; k++) {
+      T *xk = xd + k * ldx;
+      const T inv = T(1) / a[k * ld + k];
+      for (long j = j0; j < j1; j++) xk[j] *= inv;
+      for (int i = k + 1; i < n; i++) {
+        const T l = conjugate(a[k * ld + i]);
+        if (l == T(0)) continue;
+        T *xi = xd + i * ldx;
+        for (long j = j0; j < j1; j++) xi[j] -= l * xk[j];
+      }
+    }
+    // U * x = y
+    back_substitute(a, ld, n, xd, ldx, j0, j1);
+  };
+  S21ThreadPool::ParallelFor(0, m, static_cast<long>(n) * n * m, substitute);
+  return x;
+}
+
+template <typename T>
+S21BasicMatrix<T> S21BasicCholesky<T>::InverseMatrix() const {
+  const int n = size();
+  Matrix identity(n, n);
+  for (int i = 0; i < n; i++) identity(i, i) = T(1);
+  return Solve(identity);
+}
+
+// QR
+
+// Reflector k maps column k below the diagonal onto (beta, 0, ..., 0) as
+// LAPACK's xLARFG does, then H^H = I - conj(tau) * v * v^H is applied to
+// the columns on its right, in parallel over column ranges.
+template <typename T>
+S21BasicQR<T>::S21BasicQR(const Matrix &A) : S21BasicQR(Matrix(A)) {}
+
+template <typename T>
+S21BasicQR<T>::S21BasicQR(Matrix &&A)
+    : qr_(std::move(A)), tau_(qr_.getCols()), rank_deficient_(false) {
+  const int m = qr_.getRows(), n = qr_.getCols();
+  if (m < n)
+    throw std::out_of_range(
+        "Incorrect input, matrix should have at least as many rows as cols");
+  S21_STATS_SCOPE(kQR, 2ULL * m * n * n - 2ULL * n * n * n / 3);
+  const int ld = qr_.stride();
+  T *a = qr_.data();
+  const real_type tiny =
+      m * std::numeric_limits<real_type>::epsilon() * max_abs(a, ld, m, n);
+
+  for (int k = 0; k < n; k++) {
+    const T alpha = a[k * ld + k];
+    real_type norm = 0;
+    for (int i = k + 1; i < m; i++) norm += std::norm(a[i * ld + k]);
+    T tau = T(0);
+    real_type beta = std::real(alpha);
+    if (norm != 0 || std::imag(alpha) != 0) {
+      beta = -std::copysign(std::sqrt(std::norm(alpha) + norm),
+                            std::real(alpha));
+      tau = (T(beta) - alpha) / T(beta);
+      const T scale = T(1) / (alpha - T(beta));
+      for (int i = k + 1; i < m; i++) a[i * ld + k] *= scale;
+      a[k * ld + k] = T(beta);
+    }
+    tau_[k] = tau;
+    if (!(std::abs(beta) > tiny)) rank_deficient_ = true;
+    if (tau == T(0) || k + 1 == n) continue;
+    const long cost = static_cast<long>(m - k) * (n - k - 1);
+    S21ThreadPool::ParallelFor(k + 1, n, cost, [=](long j0, long j1) {
+      reflect(a, ld, m, k, conjugate(tau), a, ld, j0, j1);
+    });
+  }
+}
+
+template <typename T>
+S21BasicMatrix<T> S21BasicQR<T>::Q() const {
+  const int m = getRows(), n = getCols();
+  const int ld = qr_.stride();
+  const T *a = qr_.data();
+  Matrix q(m, n);
+  const int ldq = q.stride();
+  T *qd = q.data();
+  for (int i = 0; i < n; i++) qd[i * ldq + i] = T(1);
+  // Q = H_0 * ... * H_(n-1) applied to the identity from the right end
+  for (int k = n - 1; k >= 0; k--) {
+    if (tau_[k] == T(0)) continue;
+    const long cost = static_cast<long>(m - k) * (n - k);
+    S21ThreadPool::ParallelFor(k, n, cost, [&](long j0, long j1) {
+      reflect(a, ld, m, k, tau_[k], qd, ldq, j0, j1);
+    });
+  }
+  return q;
+}
+
+template <typename T>
+S21BasicMatrix<T> S21BasicQR<T>::R() const {
+  const int n = getCols();
+  Matrix r(n, n);
+  for (int i = 0; i < n; i++)
+    std::copy_n(qr_.data() + i * qr_.stride() + i, n - i,
+                r.data() + i * r.stride() + i);
+  return r;
+}
+
+template <typename T>
+S21BasicMatrix<T> S21BasicQR<T>::Solve(const Matrix &b) const {
+  const int m = getRows(), n = getCols();
+  if (b.getRows() != m)
+    throw std::out_of_range(
+        "Incorrect input, right-hand side should have as many rows as A");
+  if (rank_deficient_) throw std::out_of_range("Matrix is rank deficient");
+
+  const int cols = b.getCols();
+  S21_STATS_SCOPE(kSolve, (4ULL * m * n - 1ULL * n * n) * cols);
+  Matrix y = copy_rows(b, m);
+  const int ld = qr_.stride(), ldy = y.stride();
+  const T *a = qr_.data();
+  T *yd = y.data();
+  // y = Q^H * b, then R * x = y[0:n]
+  auto substitute = [&](long j0, long j1) {
+    for (int k = 0; k < n; k++)
+      if (tau_[k] != T(0))
+        reflect(a, ld, m, k, conjugate(tau_[k]), yd, ldy, j0, j1);
+    back_substitute(a, ld, n, yd, ldy, j0, j1);
+  };
+  S21ThreadPool::ParallelFor(0, cols, 2L * m * n * cols, substitute);
+  if (m == n) return y;
+  return copy_rows(y, n);
+}
+
+template class S21BasicCholesky<float>;
+template class S21BasicCholesky<double>;
+template class S21BasicCholesky<long double>;
+template class S21BasicCholesky<std::complex<double>>;
+template class S21BasicQR<float>;
+template class S21BasicQR<double>;
+template class S21BasicQR<long double>;
+template class S21BasicQR<std::complex<double>>;
@@ -0,0 +1,286 @@
+#include "s21_matrix_io.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace {
+
+constexpr char kMagic[4] = {'S', '2', '1', 'M'};
+constexpr std::uint32_t kByteOrder = 0x01020304;
+constexpr std::uint16_t kVersion = 1;
+constexpr std::uint64_t kDataOffset = 64;
+// Elements gathered per write() when the source rows are not contiguous
+constexpr std::size_t kWriteChunk = 1 << 20;
+
+struct Header {
+  char magic[4];
+  std::uint32_t byte_order;
+  std::uint16_t version;
+  std::uint8_t type;
+  std::uint8_t layout;
+  std::uint32_t element_size;
+  std::uint64_t rows;
+  std::uint64_t cols;
+  std::uint64_t data_offset;
+  std::uint8_t reserved[24];
+};
+static_assert(sizeof(Header) == kDataOffset, "header is one cache line");
+
+[[noreturn]] void fail(const std::string &what, const std::string &path) {
+  throw std::runtime_error("Error! " + what + ": " + path);
+}
+
+[[noreturn]] void fail_errno(const std::string &what,
+                             const std::string &path) {
+  fail(what + " (" + std::strerror(errno) + ")", path);
+}
+
+// Owns a file descriptor
+class File {
+ private:
+  int fd_;
+  std::string path_;
+
+ public:
+  File(const std::string &path, int flags)
+      : fd_(::open(path.c_str(), flags | O_CLOEXEC, 0644)), path_(path) {
+    if (fd_ < 0) fail_errno("Cannot open file", path_);
+  }
+  File(const File &) = delete;
+  File &operator=(const File &) = delete;
+  ~File() {
+    if (fd_ >= 0) ::close(fd_);
+  }
+
+  [[nodiscard]] int fd() const noexcept { return fd_; }
+
+  // write() and read() may transfer less than asked, large blocks included
+  void WriteAll(const void *buffer, std::size_t bytes) {
+    const char *p = static_cast<const char *>(buffer);
+    while (bytes > 0) {
+      const ssize_t done = ::write(fd_, p, bytes);
+      if (done < 0 && errno == EINTR) continue;
+      if (done <= 0) fail_errno("Cannot write file", path_);
+      p += done;
+      bytes -= done;
+    }
+  }
+  void ReadAll(void *buffer, std::size_t bytes) {
+    char *p = static_cast<char *>(buffer);
+    while (bytes > 0) {
+      const ssize_t done = ::read(fd_, p, bytes);
+      if (done < 0 && errno == EINTR) continue;
+      if (done < 0) fail_errno("Cannot read file", path_);
+      if (done == 0) fail("Unexpected end of file", path_);
+      p += done;
+      bytes -= done;
+    }
+  }
+  [[nodiscard]] std::uint64_t Size() const {
+    struct stat st;
+    if (::fstat(fd_, &st) != 0) fail_errno("Cannot stat file", path_);
+    return static_cast<std::uint64_t>(st.st_size);
+  }
+};
+
+// data_offset + rows * cols * element_size, the bytes a valid file spans;
+// a crafted header whose size does not fit in 64 bits is rejected
+std::uint64_t file_length(const Header &header, std::uint64_t element_size,
+                          const std::string &path) {
+  constexpr std::uint64_t max = std::numeric_limits<std::uint64_t>::max();
+  if (header.rows > max / header.cols ||
+      header.rows * header.cols > max / element_size)
+    fail("Invalid matrix file dimensions", path);
+  const std::uint64_t bytes = header.rows * header.cols * element_size;
+  if (bytes > max - header.data_offset)
+    fail("Invalid matrix file data offset", path);
+  return header.data_offset + bytes;
+}
+
+// Reads and validates the header; the file offset is left at the data
+Header read_header(File &file, const std::string &path) {
+  Header header;
+  file.ReadAll(&header, sizeof(header));
+  if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0)
+    fail("Not a matrix file", path);
+  if (header.byte_order != kByteOrder)
+    fail("Matrix file has a different byte order", path);
+  if (header.version != kVersion)
+    fail("Unsupported matrix file version", path);
+  if (header.layout != static_cast<std::uint8_t>(S21FileLayout::kRowMajor))
+    fail("Unsupported matrix file layout", path);
+  constexpr std::uint64_t max = std::numeric_limits<int>::max();
+  if (header.rows == 0 || header.cols == 0 || header.rows > max ||
+      header.cols > max)
+    fail("Invalid matrix file dimensions", path);
+  if (header.element_size == 0 || header.element_size > 64)
+    fail("Invalid matrix file element size", path);
+  if (header.data_offset < sizeof(header) ||
+      header.data_offset % S21BasicMatrix<double>::kAlignment != 0)
+    fail("Invalid matrix file data offset", path);
+  if (file.Size() < file_length(header, header.element_size, path))
+    fail("Matrix file is truncated", path);
+  if (::lseek(file.fd(), static_cast<off_t>(header.data_offset), SEEK_SET) <
+      0)
+    fail_errno("Cannot seek file", path);
+  return header;
+}
+
+template <typename T>
+void check_type(const Header &header, const std::string &path) {
+  if (header.type != static_cast<std::uint8_t>(S21FileTypeOf<T>::kValue) ||
+      header.element_size != sizeof(T))
+    fail("Matrix file holds a different element type", path);
+}
+
+}  // namespace
+
+S21MatrixFileInfo S21ReadMatrixInfo(const std::string &path) {
+  File file(path, O_RDONLY);
+  const Header header = read_header(file, path);
+  return {static_cast<int>(header.rows), static_cast<int>(header.cols),
+          static_cast<S21FileType>(header.type),
+          static_cast<S21FileLayout>(header.layout)};
+}
+
+template <typename T>
+void S21SaveMatrix(const S21BasicMatrixView<const T> &matrix,
+                   const std::string &path) {
+  const int rows = matrix.getRows(), cols = matrix.getCols();
+  Header header{};
+  std::memcpy(header.magic, kMagic, sizeof(kMagic));
+  header.byte_order = kByteOrder;
+  header.version = kVersion;
+  header.type = static_cast<std::uint8_t>(S21FileTypeOf<T>::kValue);
+  header.layout = static_cast<std::uint8_t>(S21FileLayout::kRowMajor);
+  header.element_size = sizeof(T);
+  header.rows = rows;
+  header.cols = cols;
+  header.data_offset = kDataOffset;
+
+  File file(path, O_WRONLY | O_CREAT | O_TRUNC);
+  file.WriteAll(&header, sizeof(header));
+  if (matrix.colStride() == 1 && matrix.rowStride() == cols) {
+    file.WriteAll(matrix.data(), sizeof(T) * rows * cols);
+    return;
+  }
+  // Whole rows are gathered into a buffer and written together
+  const int batch = std::max<int>(1, kWriteChunk / sizeof(T) / cols);
+  std::vector<T> buffer(static_cast<std::size_t>(batch) * cols);
+  for (int first = 0; first < rows; first += batch) {
+    const int last = std::min(rows, first + batch);
+    T *out = buffer.data();
+    for (int i = first; i < last; i++)
+      for (int j = 0; j < cols; j++) *out++ = matrix.eval(i, j);
+    file.WriteAll(buffer.data(), sizeof(T) * (out - buffer.data()));
+  }
+}
+
+template <typename T>
+S21BasicMatrix<T> S21LoadMatrix(const std::string &path,
+                                std::pmr::memory_resource *resource) {
+  File file(path, O_RDONLY);
+  const Header header = read_header(file, path);
+  check_type<T>(header, path);
+  const int rows = static_cast<int>(header.rows);
+  const int cols = static_cast<int>(header.cols);
+  S21BasicMatrix<T> sol(rows, cols, resource);
+  if (sol.stride() == cols) {
+    file.ReadAll(sol.data(), sizeof(T) * rows * cols);
+  } else {
+    for (int i = 0; i < rows; i++)
+      file.ReadAll(sol.data() + static_cast<long>(i) * sol.stride(),
+                   sizeof(T) * cols);
+  }
+  return sol;
+}
+
+template <typename T>
+S21BasicMappedMatrix<T>::S21BasicMappedMatrix(const std::string &path)
+    : mapping_(nullptr), length_(0), data_(nullptr), rows_(0), cols_(0) {
+  File file(path, O_RDONLY);
+  const Header header = read_header(file, path);
+  check_type<T>(header, path);
+  const std::uint64_t length = file_length(header, sizeof(T), path);
+  if (length > std::numeric_limits<std::size_t>::max())
+    fail("Matrix file is too large to map", path);
+  length_ = static_cast<std::size_t>(length);
+  // The mapping stays valid after the descriptor is closed
+  void *mapping =
+      ::mmap(nullptr, length_, PROT_READ, MAP_PRIVATE, file.fd(), 0);
+  if (mapping == MAP_FAILED) fail_errno("Cannot map file", path);
+  mapping_ = mapping;
+  data_ = reinterpret_cast<const T *>(static_cast<const char *>(mapping_) +
+                                      header.data_offset);
+  rows_ = static_cast<int>(header.rows);
+  cols_ = static_cast<int>(header.cols);
+}
+
+template <typename T>
+S21BasicMappedMatrix<T>::S21BasicMappedMatrix(
+    S21BasicMappedMatrix &&other) noexcept
+    : mapping_(std::exchange(other.mapping_, nullptr)),
+      length_(std::exchange(other.length_, 0)),
+      data_(std::exchange(other.data_, nullptr)),
+      rows_(std::exchange(other.rows_, 0)),
+      cols_(std::exchange(other.cols_, 0)) {}
+
+template <typename T>
+S21BasicMappedMatrix<T> &S21BasicMappedMatrix<T>::operator=(
+    S21BasicMappedMatrix &&other) noexcept {
+  if (this != &other) {
+    unmap();
+    mapping_ = std::exchange(other.mapping_, nullptr);
+    length_ = std::exchange(other.length_, 0);
+    data_ = std::exchange(other.data_, nullptr);
+    rows_ = std::exchange(other.rows_, 0);
+    cols_ = std::exchange(other.cols_, 0);
+  }
+  return *this;
+}
+
+template <typename T>
+S21BasicMappedMatrix<T>::~S21BasicMappedMatrix() {
+  unmap();
+}
+
+template <typename T>
+void S21BasicMappedMatrix<T>::unmap() noexcept {
+  if (mapping_ != nullptr) ::munmap(mapping_, length_);
+  mapping_ = nullptr;
+}
+
+template void S21SaveMatrix(const S21BasicMatrixView<const float> &,
+                            const std::string &);
+template void S21SaveMatrix(const S21BasicMatrixView<const double> &,
+                            const std::string &);
+template void S21SaveMatrix(const S21BasicMatrixView<const long double> &,
+                            const std::string &);
+template void S21SaveMatrix(
+    const S21BasicMatrixView<const std::complex<double>> &,
+    const std::string &);
+
+template S21BasicMatrix<float> S21LoadMatrix<float>(
+    const std::string &, std::pmr::memory_resource *);
+template S21BasicMatrix<double> S21LoadMatrix<double>(
+    const std::string &, std::pmr::memory_resource *);
+template S21BasicMatrix<long double> S21LoadMatrix<long double>(
+    const std::string &, std::pmr::memory_resource *);
+template S21BasicMatrix<std::complex<double>>
+S21LoadMatrix<std::complex<double>>(
+    const std::string &, std::pmr::memory_resource *);
+
+template class S21BasicMappedMatrix<float>;
+template class S21BasicMappedMatrix<double>;
+template class S21BasicMappedMatrix<long double>;
+template class S21BasicMappedMatrix<std::complex<double>>;
@@ -0,0 +1,126 @@
+#ifndef MATRIX_SRC_S21_MATRIX_IO_H
+#define MATRIX_SRC_S21_MATRIX_IO_H
+
+#include <complex>
+#include <cstdint>
+#include <string>
+
+#include "s21_matrix_oop.h"
+#include "s21_matrix_view.h"
+
+// Binary matrix files. A 64 byte header is followed by the elements in
+// row-major order without padding, starting at a 64 byte aligned offset,
+// so a memory-mapped file can be read in place:
+//
+//   offset  size  field
+//        0     4  magic "S21M"
+//        4     4  byte order mark 0x01020304 as written by the host
+//        8     2  format version (1)
+//       10     1  element type, S21FileType
+//       11     1  layout, S21FileLayout
+//       12     4  element size in bytes
+//       16     8  rows
+//       24     8  cols
+//       32     8  offset of the first element
+//       40    24  zero
+//
+// Files are read by the machine type that wrote them: a different byte
+// order, element type or element size is rejected. I/O and format errors
+// throw std::runtime_error.
+
+enum class S21FileType : std::uint8_t {
+  kFloat = 1,
+  kDouble = 2,
+  kLongDouble = 3,
+  kComplexDouble = 4
+};
+
+enum class S21FileLayout : std::uint8_t { kRowMajor = 0 };
+
+// File type code of an element type
+template <typename T>
+struct S21FileTypeOf;
+template <>
+struct S21FileTypeOf<float> {
+  static constexpr S21FileType kValue = S21FileType::kFloat;
+};
+template <>
+struct S21FileTypeOf<double> {
+  static constexpr S21FileType kValue = S21FileType::kDouble;
+};
+template <>
+struct S21FileTypeOf<long double> {
+  static constexpr S21FileType kValue = S21FileType::kLongDouble;
+};
+template <>
+struct S21FileTypeOf<std::complex<double>> {
+  static constexpr S21FileType kValue = S21FileType::kComplexDouble;
+};
+
+// Dimensions and element type stored in a file, read from its header only
+struct S21MatrixFileInfo {
+  int rows, cols;
+  S21FileType type;
+  S21FileLayout layout;
+};
+
+[[nodiscard]] S21MatrixFileInfo S21ReadMatrixInfo(const std::string &path);
+
+// Writes the elements of `matrix` (any view, including a strided one)
+template <typename T>
+void S21SaveMatrix(const S21BasicMatrixView<const T> &matrix,
+                   const std::string &path);
+template <typename T>
+void S21SaveMatrix(const S21BasicMatrix<T> &matrix, const std::string &path) {
+  S21SaveMatrix(S21BasicMatrixView<const T>(matrix), path);
+}
+template <typename T>
+void S21SaveMatrix(const S21BasicMatrixView<T> &matrix,
+                   const std::string &path) {
+  S21SaveMatrix(S21BasicMatrixView<const T>(matrix), path);
+}
+
+// Reads a whole file into a new matrix allocated from `resource` (the
+// current resource when null) with one read for the element block
+template <typename T>
+[[nodiscard]] S21BasicMatrix<T> S21LoadMatrix(
+    const std::string &path, std::pmr::memory_resource *resource = nullptr);
+
+// Read-only memory mapping of a matrix file. Nothing is read up front:
+// pages are loaded by the OS as the elements are touched, and View() is
+// valid for as long as the mapping lives. `S21Matrix m = mapped.View();`
+// makes an owned copy.
+template <typename T>
+class S21BasicMappedMatrix {
+ private:
+  void *mapping_;
+  std::size_t length_;
+  const T *data_;
+  int rows_, cols_;
+
+  void unmap() noexcept;
+
+ public:
+  explicit S21BasicMappedMatrix(const std::string &path);
+  S21BasicMappedMatrix(const S21BasicMappedMatrix &) = delete;
+  S21BasicMappedMatrix &operator=(const S21BasicMappedMatrix &) = delete;
+  S21BasicMappedMatrix(S21BasicMappedMatrix &&other) noexcept;
+  S21BasicMappedMatrix &operator=(S21BasicMappedMatrix &&other) noexcept;
+  ~S21BasicMappedMatrix();
+
+  [[nodiscard]] int getRows() const noexcept { return rows_; }
+  [[nodiscard]] int getCols() const noexcept { return cols_; }
+  [[nodiscard]] const T *data() const noexcept { return data_; }
+  [[nodiscard]] S21BasicMatrixView<const T> View() const {
+    return S21BasicMatrixView<const T>(data_, rows_, cols_);
+  }
+};
+
+using S21MappedMatrix = S21BasicMappedMatrix<double>;
+
+extern template class S21BasicMappedMatrix<float>;
+extern template class S21BasicMappedMatrix<double>;
+extern template class S21BasicMappedMatrix<long double>;
+extern template class S21BasicMappedMatrix<std::complex<double>>;
+
+#endif  // MATRIX_SRC_S21_MATRIX_IO_H
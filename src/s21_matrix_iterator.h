@@ -0,0 +1,175 @@
+#ifndef MATRIX_SRC_S21_MATRIX_ITERATOR_H
+#define MATRIX_SRC_S21_MATRIX_ITERATOR_H
+
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+
+// Unchecked access to the rows and elements of a row-major buffer whose
+// rows are `stride` elements apart. None of these types check bounds or
+// own memory; they stay valid until the matrix is resized or destroyed.
+
+// Contiguous run of elements, a stand-in for C++20 std::span
+template <typename T>
+class S21Span {
+ private:
+  T *data_;
+  int size_;
+
+ public:
+  using value_type = std::remove_const_t<T>;
+  using iterator = T *;
+
+  constexpr S21Span() noexcept : data_(nullptr), size_(0) {}
+  constexpr S21Span(T *data, int size) noexcept : data_(data), size_(size) {}
+
+  [[nodiscard]] constexpr T *data() const noexcept { return data_; }
+  [[nodiscard]] constexpr int size() const noexcept { return size_; }
+  [[nodiscard]] constexpr bool empty() const noexcept { return size_ == 0; }
+  [[nodiscard]] constexpr T *begin() const noexcept { return data_; }
+  [[nodiscard]] constexpr T *end() const noexcept { return data_ + size_; }
+  constexpr T &operator[](int j) const noexcept { return data_[j]; }
+};
+
+// Visits the elements row by row, stepping over the padding at the end
+// of each row
+template <typename T>
+class S21ElementIterator {
+ private:
+  T *ptr_;
+  T *row_end_;  // End of the current row's elements
+  int cols_, gap_;  // Elements per row, padding after each
+
+ public:
+  using iterator_category = std::forward_iterator_tag;
+  using value_type = std::remove_const_t<T>;
+  using difference_type = std::ptrdiff_t;
+  using pointer = T *;
+  using reference = T &;
+
+  S21ElementIterator() noexcept
+      : ptr_(nullptr), row_end_(nullptr), cols_(0), gap_(0) {}
+  // At the start of the row beginning at `row`
+  S21ElementIterator(T *row, int cols, int stride) noexcept
+      : ptr_(row), row_end_(row + cols), cols_(cols), gap_(stride - cols) {}
+
+  T &operator*() const noexcept { return *ptr_; }
+  T *operator->() const noexcept { return ptr_; }
+  S21ElementIterator &operator++() noexcept {
+    if (++ptr_ == row_end_) {
+      ptr_ += gap_;
+      row_end_ = ptr_ + cols_;
+    }
+    return *this;
+  }
+  S21ElementIterator operator++(int) noexcept {
+    S21ElementIterator old = *this;
+    ++*this;
+    return old;
+  }
+  bool operator==(const S21ElementIterator &other) const noexcept {
+    return ptr_ == other.ptr_;
+  }
+  bool operator!=(const S21ElementIterator &other) const noexcept {
+    return ptr_ != other.ptr_;
+  }
+};
+
+// Visits the rows as S21Span
+template <typename T>
+class S21RowIterator {
+ private:
+  T *row_;
+  int cols_, stride_;
+
+ public:
+  using iterator_category = std::random_access_iterator_tag;
+  using value_type = S21Span<T>;
+  using difference_type = std::ptrdiff_t;
+  using pointer = void;
+  using reference = S21Span<T>;
+
+  S21RowIterator() noexcept : row_(nullptr), cols_(0), stride_(0) {}
+  S21RowIterator(T *row, int cols, int stride) noexcept
+      : row_(row), cols_(cols), stride_(stride) {}
+
+  S21Span<T> operator*() const noexcept { return S21Span<T>(row_, cols_); }
+  S21Span<T> operator[](difference_type n) const noexcept {
+    return S21Span<T>(row_ + n * stride_, cols_);
+  }
+  S21RowIterator &operator++() noexcept {
+    row_ += stride_;
+    return *this;
+  }
+  S21RowIterator operator++(int) noexcept {
+    S21RowIterator old = *this;
+    row_ += stride_;
+    return old;
+  }
+  S21RowIterator &operator--() noexcept {
+    row_ -= stride_;
+    return *this;
+  }
+  S21RowIterator operator--(int) noexcept {
+    S21RowIterator old = *this;
+    row_ -= stride_;
+    return old;
+  }
+  S21RowIterator &operator+=(difference_type n) noexcept {
+    row_ += n * stride_;
+    return *this;
+  }
+  S21RowIterator &operator-=(difference_type n) noexcept {
+    row_ -= n * stride_;
+    return *this;
+  }
+  S21RowIterator operator+(difference_type n) const noexcept {
+    return S21RowIterator(row_ + n * stride_, cols_, stride_);
+  }
+  S21RowIterator operator-(difference_type n) const noexcept {
+    return S21RowIterator(row_ - n * stride_, cols_, stride_);
+  }
+  difference_type operator-(const S21RowIterator &other) const noexcept {
+    return stride_ == 0 ? 0 : (row_ - other.row_) / stride_;
+  }
+  bool operator==(const S21RowIterator &other) const noexcept {
+    return row_ == other.row_;
+  }
+  bool operator!=(const S21RowIterator &other) const noexcept {
+    return row_ != other.row_;
+  }
+  bool operator<(const S21RowIterator &other) const noexcept {
+    return row_ < other.row_;
+  }
+  bool operator>(const S21RowIterator &other) const noexcept {
+    return row_ > other.row_;
+  }
+  bool operator<=(const S21RowIterator &other) const noexcept {
+    return row_ <= other.row_;
+  }
+  bool operator>=(const S21RowIterator &other) const noexcept {
+    return row_ >= other.row_;
+  }
+};
+
+// Range of rows for range-based for loops
+template <typename T>
+class S21RowRange {
+ private:
+  S21RowIterator<T> begin_, end_;
+
+ public:
+  S21RowRange(T *data, int rows, int cols, int stride) noexcept
+      : begin_(data, cols, stride),
+        end_(data + static_cast<std::ptrdiff_t>(rows) * stride, cols,
+             stride) {}
+
+  [[nodiscard]] S21RowIterator<T> begin() const noexcept { return begin_; }
+  [[nodiscard]] S21RowIterator<T> end() const noexcept { return end_; }
+  [[nodiscard]] int size() const noexcept {
+    return static_cast<int>(end_ - begin_);
+  }
+  S21Span<T> operator[](int i) const noexcept { return begin_[i]; }
+};
+
+#endif  // MATRIX_SRC_S21_MATRIX_ITERATOR_H
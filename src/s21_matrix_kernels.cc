@@ -0,0 +1,277 @@
+#include "s21_matrix_kernels.h"
+
+#include <algorithm>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+#include "s21_thread_pool.h"
+
+namespace s21 {
+
+namespace {
+
+// Products with at most this many multiply-adds skip packing entirely
+constexpr long kGemmSmall = 32L * 32L * 32L;
+
+// Growing per-thread scratch buffers for the packed panels
+template <typename T>
+T *scratch_a(std::size_t size) {
+  thread_local std::vector<T> buffer;
+  if (buffer.size() < size) buffer.resize(size);
+  return buffer.data();
+}
+
+template <typename T>
+T *scratch_b(std::size_t size) {
+  thread_local std::vector<T> buffer;
+  if (buffer.size() < size) buffer.resize(size);
+  return buffer.data();
+}
+
+template <typename T>
+void scale_c(int m, int n, T beta, T *c, long ldc) {
+  if (beta == T(1)) return;
+  for (int i = 0; i < m; i++) {
+    T *row = c + i * ldc;
+    if (beta == T(0)) {
+      std::fill(row, row + n, T(0));
+    } else {
+      for (int j = 0; j < n; j++) row[j] *= beta;
+    }
+  }
+}
+
+// Unblocked i-k-j loop for tiny operands, the inner loop runs along a row
+// of B and C.
+template <typename T>
+void gemm_small(int m, int n, int k, T alpha, const T *a, long rsa, long csa,
+                const T *b, long rsb, long csb, T *c, long ldc) {
+  for (int i = 0; i < m; i++) {
+    T *ci = c + i * ldc;
+    for (int p = 0; p < k; p++) {
+      const T aip = alpha * a[i * rsa + p * csa];
+      if (aip == T(0)) continue;
+      const T *bp = b + p * rsb;
+      if (csb == 1) {
+        for (int j = 0; j < n; j++) ci[j] += aip * bp[j];
+      } else {
+        for (int j = 0; j < n; j++) ci[j] += aip * bp[j * csb];
+      }
+    }
+  }
+}
+
+// Packs an mc x kc block of A into row panels of kGemmMr rows, each stored
+// column by column; the fringe is padded with zeros.
+template <typename T>
+void pack_a(int mc, int kc, const T *a, long rsa, long csa, T *packed) {
+  for (int ir = 0; ir < mc; ir += kGemmMr) {
+    const int mr = std::min(kGemmMr, mc - ir);
+    for (int p = 0; p < kc; p++) {
+      for (int i = 0; i < mr; i++)
+        packed[i] = a[(ir + i) * rsa + p * csa];
+      for (int i = mr; i < kGemmMr; i++) packed[i] = T(0);
+      packed += kGemmMr;
+    }
+  }
+}
+
+// Packs a kc x nc block of B into column panels of kGemmNr columns, each
+// stored row by row; the fringe is padded with zeros.
+template <typename T>
+void pack_b(int kc, int nc, const T *b, long rsb, long csb, T *packed) {
+  for (int jr = 0; jr < nc; jr += kGemmNr) {
+    const int nr = std::min(kGemmNr, nc - jr);
+    for (int p = 0; p < kc; p++) {
+      const T *src = b + p * rsb + jr * csb;
+      if (csb == 1) {
+        for (int j = 0; j < nr; j++) packed[j] = src[j];
+      } else {
+        for (int j = 0; j < nr; j++) packed[j] = src[j * csb];
+      }
+      for (int j = nr; j < kGemmNr; j++) packed[j] = T(0);
+      packed += kGemmNr;
+    }
+  }
+}
+
+// Register tile for the element types without a vector kernel
+template <typename T>
+void micro_kernel(int kc, T alpha, const T *a, const T *b, T *c, long ldc,
+                  int mr, int nr) {
+  if constexpr (std::is_same_v<T, double>) {
+    gemm_micro_kernel(kc, alpha, a, b, c, ldc, mr, nr);
+  } else {
+    T acc[kGemmMr][kGemmNr] = {};
+    for (int p = 0; p < kc; p++) {
+      for (int i = 0; i < kGemmMr; i++) {
+        const T ai = a[i];
+        for (int j = 0; j < kGemmNr; j++) acc[i][j] += ai * b[j];
+      }
+      a += kGemmMr;
+      b += kGemmNr;
+    }
+    for (int i = 0; i < mr; i++) {
+      T *ci = c + i * ldc;
+      for (int j = 0; j < nr; j++) ci[j] += alpha * acc[i][j];
+    }
+  }
+}
+
+// Multiplies the packed blocks into an mc x nc block of C
+template <typename T>
+void macro_kernel(int mc, int nc, int kc, T alpha, const T *a, const T *b,
+                  T *c, long ldc) {
+  for (int jr = 0; jr < nc; jr += kGemmNr) {
+    const int nr = std::min(kGemmNr, nc - jr);
+    for (int ir = 0; ir < mc; ir += kGemmMr) {
+      const int mr = std::min(kGemmMr, mc - ir);
+      micro_kernel(kc, alpha, a + ir * kc, b + jr * kc, c + ir * ldc + jr,
+                   ldc, mr, nr);
+    }
+  }
+}
+
+}  // namespace
+
+template <typename T>
+void gemm(int m, int n, int k, T alpha, const T *a, long rsa, long csa,
+          const T *b, long rsb, long csb, T beta, T *c, long ldc) {
+  if (m <= 0 || n <= 0) return;
+  scale_c(m, n, beta, c, ldc);
+  if (k <= 0 || alpha == T(0)) return;
+  if (static_cast<long>(m) * n * k <= kGemmSmall) {
+    gemm_small(m, n, k, alpha, a, rsa, csa, b, rsb, csb, c, ldc);
+    return;
+  }
+
+  const int nc_max = std::min(kGemmNc, n);
+  const int kc_max = std::min(kGemmKc, k);
+  const std::size_t size_a = static_cast<std::size_t>(kGemmMc) * kc_max;
+  T *packed_b =
+      scratch_b<T>(static_cast<std::size_t>(nc_max + kGemmNr) * kc_max);
+  const long blocks = (m + kGemmMc - 1) / kGemmMc;
+
+  for (int jc = 0; jc < n; jc += kGemmNc) {
+    const int nc = std::min(kGemmNc, n - jc);
+    for (int pc = 0; pc < k; pc += kGemmKc) {
+      const int kc = std::min(kGemmKc, k - pc);
+      pack_b(kc, nc, b + pc * rsb + jc * csb, rsb, csb, packed_b);
+      // row blocks of C are independent, each thread packs its own A block
+      S21ThreadPool::ParallelFor(
+          0, blocks, static_cast<long>(m) * nc * kc,
+          [&](long first, long last) {
+            T *packed_a = scratch_a<T>(size_a);
+            for (long block = first; block < last; block++) {
+              const int ic = static_cast<int>(block) * kGemmMc;
+              const int mc = std::min(kGemmMc, m - ic);
+              pack_a(mc, kc, a + ic * rsa + pc * csa, rsa, csa, packed_a);
+              macro_kernel(mc, nc, kc, alpha, packed_a, packed_b,
+                           c + ic * ldc + jc, ldc);
+            }
+          });
+    }
+  }
+}
+
+namespace {
+
+// z = x + y, or x - y when subtract; z may be x or y
+template <typename T>
+void combine(int m, int n, const T *x, long ldx, const T *y, long ldy, T *z,
+             long ldz, bool subtract) {
+  S21ThreadPool::ParallelFor(
+      0, m, static_cast<long>(m) * n, [&](long first, long last) {
+        for (long i = first; i < last; i++) {
+          const T *xi = x + i * ldx;
+          const T *yi = y + i * ldy;
+          T *zi = z + i * ldz;
+          if (subtract) {
+            vec_sub(zi, xi, yi, n);
+          } else {
+            vec_add(zi, xi, yi, n);
+          }
+        }
+      });
+}
+
+// One level on the even-sized leading part, with the three temporaries of
+// the schedule by Boyer, Dumas, Pernet and Zhou: the seven products go to
+// the quadrants of C and a single extra block
+template <typename T>
+void strassen_level(int m, int n, int k, const T *a, long lda, const T *b,
+                    long ldb, T *c, long ldc, int cutoff) {
+  const int m2 = m / 2, n2 = n / 2, k2 = k / 2;
+  const T *a11 = a, *a12 = a + k2, *a21 = a + m2 * lda,
+          *a22 = a + m2 * lda + k2;
+  const T *b11 = b, *b12 = b + n2, *b21 = b + k2 * ldb,
+          *b22 = b + k2 * ldb + n2;
+  T *c11 = c, *c12 = c + n2, *c21 = c + m2 * ldc, *c22 = c + m2 * ldc + n2;
+  // every element is written before it is read, no need to zero them
+  std::unique_ptr<T[]> x(new T[static_cast<std::size_t>(m2) * k2]);
+  std::unique_ptr<T[]> y(new T[static_cast<std::size_t>(k2) * n2]);
+  std::unique_ptr<T[]> z(new T[static_cast<std::size_t>(m2) * n2]);
+  T *xd = x.get(), *yd = y.get(), *zd = z.get();
+
+  combine(m2, k2, a11, lda, a21, lda, xd, k2, true);   // S3 = A11 - A21
+  combine(k2, n2, b22, ldb, b12, ldb, yd, n2, true);   // T3 = B22 - B12
+  strassen(m2, n2, k2, xd, k2, yd, n2, c21, ldc, cutoff);  // P7 = S3 T3
+  combine(m2, k2, a21, lda, a22, lda, xd, k2, false);  // S1 = A21 + A22
+  combine(k2, n2, b12, ldb, b11, ldb, yd, n2, true);   // T1 = B12 - B11
+  strassen(m2, n2, k2, xd, k2, yd, n2, c22, ldc, cutoff);  // P5 = S1 T1
+  combine(m2, k2, xd, k2, a11, lda, xd, k2, true);     // S2 = S1 - A11
+  combine(k2, n2, b22, ldb, yd, n2, yd, n2, true);     // T2 = B22 - T1
+  strassen(m2, n2, k2, xd, k2, yd, n2, c12, ldc, cutoff);  // P6 = S2 T2
+  combine(m2, k2, a12, lda, xd, k2, xd, k2, true);     // S4 = A12 - S2
+  strassen(m2, n2, k2, xd, k2, b22, ldb, c11, ldc, cutoff);  // P3 = S4 B22
+  strassen(m2, n2, k2, a11, lda, b11, ldb, zd, n2, cutoff);  // P1
+  combine(m2, n2, zd, n2, c12, ldc, c12, ldc, false);  // U2 = P1 + P6
+  combine(m2, n2, c12, ldc, c21, ldc, c21, ldc, false);  // U3 = U2 + P7
+  combine(m2, n2, c12, ldc, c22, ldc, c12, ldc, false);  // U4 = U2 + P5
+  combine(m2, n2, c21, ldc, c22, ldc, c22, ldc, false);  // C22 = U3 + P5
+  combine(m2, n2, c12, ldc, c11, ldc, c12, ldc, false);  // C12 = U4 + P3
+  combine(k2, n2, yd, n2, b21, ldb, yd, n2, true);     // T4 = T2 - B21
+  strassen(m2, n2, k2, a22, lda, yd, n2, c11, ldc, cutoff);  // P4 = A22 T4
+  combine(m2, n2, c21, ldc, c11, ldc, c21, ldc, true);  // C21 = U3 - P4
+  strassen(m2, n2, k2, a12, lda, b21, ldb, c11, ldc, cutoff);  // P2
+  combine(m2, n2, zd, n2, c11, ldc, c11, ldc, false);  // C11 = P1 + P2
+}
+
+}  // namespace
+
+template <typename T>
+void strassen(int m, int n, int k, const T *a, long lda, const T *b,
+              long ldb, T *c, long ldc, int cutoff) {
+  if (m <= 0 || n <= 0) return;
+  cutoff = std::max(cutoff, 1);
+  if (m <= cutoff || n <= cutoff || k <= cutoff) {
+    gemm(m, n, k, T(1), a, lda, 1, b, ldb, 1, T(0), c, ldc);
+    return;
+  }
+  const int me = m & ~1, ne = n & ~1, ke = k & ~1;
+  strassen_level(me, ne, ke, a, lda, b, ldb, c, ldc, cutoff);
+  // peeling: last inner index, last column, last row
+  if (ke < k)
+    gemm(me, ne, 1, T(1), a + ke, lda, 1, b + ke * ldb, ldb, 1, T(1), c, ldc);
+  if (ne < n)
+    gemm(me, 1, k, T(1), a, lda, 1, b + ne, ldb, 1, T(0), c + ne, ldc);
+  if (me < m)
+    gemm(1, n, k, T(1), a + me * lda, lda, 1, b, ldb, 1, T(0), c + me * ldc,
+         ldc);
+}
+
+#define S21_INSTANTIATE_GEMM(T)                                              \
+  template void gemm<T>(int, int, int, T, const T *, long, long, const T *, \
+                        long, long, T, T *, long);                          \
+  template void strassen<T>(int, int, int, const T *, long, const T *,      \
+                            long, T *, long, int);
+
+S21_INSTANTIATE_GEMM(float)
+S21_INSTANTIATE_GEMM(double)
+S21_INSTANTIATE_GEMM(long double)
+S21_INSTANTIATE_GEMM(std::complex<double>)
+
+#undef S21_INSTANTIATE_GEMM
+
+}  // namespace s21
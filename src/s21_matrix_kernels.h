@@ -0,0 +1,181 @@
+#ifndef MATRIX_SRC_S21_MATRIX_KERNELS_H
+#define MATRIX_SRC_S21_MATRIX_KERNELS_H
+
+// Low level compute kernels working on raw strided buffers. S21Matrix
+// forwards its heavy operations here; nothing in this header knows about
+// the matrix class itself.
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+
+namespace s21 {
+
+// Blocking parameters of the packed GEMM (in elements). A micro-panel of
+// kGemmMr x kGemmKc stays in L1, a packed block of A (kGemmMc x kGemmKc) in
+// L2 and the packed panel of B (kGemmKc x kGemmNc) in L3.
+constexpr int kGemmMr = 4;
+constexpr int kGemmNr = 8;
+constexpr int kGemmKc = 256;
+constexpr int kGemmMc = 96;
+constexpr int kGemmNc = 2048;
+
+// C = alpha * A * B + beta * C, where A is m x k and B is k x n.
+// Element (i, j) of A is a[i * rsa + j * csa], same for B, so a transposed
+// operand is expressed by swapping its row and column strides.
+// C is row-major with leading dimension ldc. Instantiated in the library
+// for float, double, long double and std::complex<double>; only double
+// uses the vector micro-kernel.
+template <typename T>
+void gemm(int m, int n, int k, T alpha, const T *a, long rsa, long csa,
+          const T *b, long rsb, long csb, T beta, T *c, long ldc);
+
+// C = A * B by the Strassen-Winograd recursion (7 half-size products and
+// 15 additions per level), with A m x k, B k x n and C m x n, all
+// row-major with leading dimensions lda, ldb and ldc. Levels stop once a
+// dimension is at most `cutoff` and continue with gemm(). Odd dimensions
+// are peeled: the even-sized part recurses and the last row, column or
+// inner index is added with gemm(). Takes O((mk + kn + mn) / 3) scratch
+// and has a larger, though still norm-wise bounded, rounding error than
+// gemm(). C must not overlap A or B.
+template <typename T>
+void strassen(int m, int n, int k, const T *a, long lda, const T *b,
+              long ldb, T *c, long ldc, int cutoff);
+
+// Instruction set picked at startup from CPUID for the vector kernels below
+enum class SimdLevel { kScalar, kAvx2, kAvx512 };
+
+[[nodiscard]] SimdLevel simd_level() noexcept;
+[[nodiscard]] const char *simd_level_name() noexcept;
+
+// Contiguous element-wise kernels over n items
+void vec_add(double *a, const double *b, long n) noexcept;    // a += b
+void vec_sub(double *a, const double *b, long n) noexcept;    // a -= b
+void vec_scale(double *a, double s, long n) noexcept;         // a *= s
+// c = a + b and c = a - b, c may be a or b
+void vec_add(double *c, const double *a, const double *b, long n) noexcept;
+void vec_sub(double *c, const double *a, const double *b, long n) noexcept;
+// y += alpha * x
+void vec_axpy(double *y, double alpha, const double *x, long n) noexcept;
+// Plane rotation of two vectors: (x, y) = (c * x + s * y, c * y - s * x)
+void vec_rot(double *x, double *y, double c, double s, long n) noexcept;
+// |a[i] - b[i]| < tolerance for every i, stops at the first failing vector
+[[nodiscard]] bool vec_equal(const double *a, const double *b, long n,
+                             double tolerance) noexcept;
+
+// Blocks of at most kTransposeBlock x kTransposeBlock elements are
+// transposed directly: one of the source and one of the destination fit in
+// L1 together
+constexpr int kTransposeBlock = 32;
+
+// Cache-oblivious transpose: halves the longer side, at multiples of the
+// 4 x 4 vector block, until the pieces are small enough for
+// leaf(rows, cols, a, lda, b, ldb). Both the reads and the writes then
+// stay within a few pages at a time, whatever the leading dimensions.
+template <typename T, typename Leaf>
+void transpose_recursive(int rows, int cols, const T *a, long lda, T *b,
+                         long ldb, Leaf leaf) noexcept {
+  // a few rows or columns are read or written in order anyway
+  if ((rows <= kTransposeBlock && cols <= kTransposeBlock) ||
+      std::min(rows, cols) <= 4) {
+    leaf(rows, cols, a, lda, b, ldb);
+  } else if (rows >= cols) {
+    const int half = (rows / 2 + 3) & ~3;
+    transpose_recursive(half, cols, a, lda, b, ldb, leaf);
+    transpose_recursive(rows - half, cols, a + half * lda, lda, b + half, ldb,
+                        leaf);
+  } else {
+    const int half = (cols / 2 + 3) & ~3;
+    transpose_recursive(rows, half, a, lda, b, ldb, leaf);
+    transpose_recursive(rows, cols - half, a + half, lda, b + half * ldb, ldb,
+                        leaf);
+  }
+}
+
+// b = a^T, where a is rows x cols with leading dimension lda
+void transpose(int rows, int cols, const double *a, long lda, double *b,
+               long ldb) noexcept;
+
+// Plain loops for the element types without vector kernels
+
+template <typename T>
+void vec_add(T *a, const T *b, long n) noexcept {
+  for (long i = 0; i < n; i++) a[i] += b[i];
+}
+
+template <typename T>
+void vec_sub(T *a, const T *b, long n) noexcept {
+  for (long i = 0; i < n; i++) a[i] -= b[i];
+}
+
+template <typename T>
+void vec_add(T *c, const T *a, const T *b, long n) noexcept {
+  for (long i = 0; i < n; i++) c[i] = a[i] + b[i];
+}
+
+template <typename T>
+void vec_sub(T *c, const T *a, const T *b, long n) noexcept {
+  for (long i = 0; i < n; i++) c[i] = a[i] - b[i];
+}
+
+template <typename T>
+void vec_scale(T *a, T s, long n) noexcept {
+  for (long i = 0; i < n; i++) a[i] *= s;
+}
+
+template <typename T>
+void vec_axpy(T *y, T alpha, const T *x, long n) noexcept {
+  for (long i = 0; i < n; i++) y[i] += alpha * x[i];
+}
+
+template <typename T>
+void vec_rot(T *x, T *y, T c, T s, long n) noexcept {
+  for (long i = 0; i < n; i++) {
+    const T xi = x[i];
+    x[i] = c * xi + s * y[i];
+    y[i] = c * y[i] - s * xi;
+  }
+}
+
+template <typename T, typename R>
+[[nodiscard]] bool vec_equal(const T *a, const T *b, long n,
+                             R tolerance) noexcept {
+  for (long i = 0; i < n; i++) {
+    if (std::abs(a[i] - b[i]) >= tolerance) return false;
+  }
+  return true;
+}
+
+template <typename T>
+void transpose(int rows, int cols, const T *a, long lda, T *b,
+               long ldb) noexcept {
+  transpose_recursive(rows, cols, a, lda, b, ldb,
+                      [](int r, int c, const T *x, long ldx, T *y, long ldy) {
+                        for (int i = 0; i < r; i++)
+                          for (int j = 0; j < c; j++)
+                            y[j * ldy + i] = x[i * ldx + j];
+                      });
+}
+
+// In-place transpose of a square matrix, one pair of mirrored blocks at a
+// time: the rows x cols block a and the cols x rows block b trade places,
+// each transposed (a == b for a diagonal block). Both sides are at most
+// kTransposeBlock, one of them is staged in a buffer.
+template <typename T>
+void transpose_swap(int rows, int cols, T *a, long lda, T *b,
+                    long ldb) noexcept {
+  T block[kTransposeBlock * kTransposeBlock];
+  transpose(rows, cols, a, lda, block, rows);
+  if (a != b) transpose(cols, rows, b, ldb, a, lda);
+  for (int j = 0; j < cols; j++)
+    std::copy_n(block + j * rows, rows, b + j * ldb);
+}
+
+// GEMM register tile: C[0:mr, 0:nr] += alpha * A_panel * B_panel over kc
+// steps, where the panels are packed by gemm() (kGemmMr / kGemmNr wide)
+void gemm_micro_kernel(int kc, double alpha, const double *a, const double *b,
+                       double *c, long ldc, int mr, int nr) noexcept;
+
+}  // namespace s21
+
+#endif  // MATRIX_SRC_S21_MATRIX_KERNELS_H
@@ -0,0 +1,153 @@
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <utility>
+#include <vector>
+
+#include "s21_matrix_oop.h"
+#include "s21_matrix_stats.h"
+#include "s21_thread_pool.h"
+
+// Doolittle elimination, right-looking, row by row so that the inner update
+// runs over contiguous memory.
+template <typename T>
+S21BasicLU<T>::S21BasicLU(const Matrix &A) : S21BasicLU(Matrix(A)) {}
+
+template <typename T>
+S21BasicLU<T>::S21BasicLU(Matrix &&A)
+    : lu_(std::move(A)), pivot_(lu_.getRows()), sign_(1), singular_(false) {
+  if (lu_.getRows() != lu_.getCols())
+    throw std::out_of_range(
+        "Incorrect input, matrices should have the same size");
+  const int n = lu_.getRows();
+  S21_STATS_SCOPE(kLU, 2ULL * n * n * n / 3);
+  const int ld = lu_.stride();
+  T *a = lu_.data();
+  std::iota(pivot_.begin(), pivot_.end(), 0);
+  // Pivots below round-off level of the whole input make A singular for
+  // solving but are still eliminated, so a badly scaled matrix keeps its
+  // determinant. Only a pivot column that cancelled down to round-off of
+  // its own entries counts as an exact zero.
+  const real_type eps = n * std::numeric_limits<real_type>::epsilon();
+  std::vector<real_type> column(n, real_type(0));
+  for (int i = 0; i < n; i++)
+    for (int j = 0; j < n; j++)
+      column[j] = std::max(column[j], std::abs(a[i * ld + j]));
+  const real_type tiny =
+      eps * *std::max_element(column.begin(), column.end());
+
+  for (int k = 0; k < n; k++) {
+    int p = k;
+    real_type max = std::abs(a[k * ld + k]);
+    for (int i = k + 1; i < n; i++) {
+      real_type value = std::abs(a[i * ld + k]);
+      if (value > max) {
+        max = value;
+        p = i;
+      }
+    }
+    if (max <= tiny) singular_ = true;
+    real_type level = column[k];
+    for (int i = 0; i < k; i++)
+      level = std::max(level, std::abs(a[i * ld + k]));
+    if (max <= eps * level) {
+      for (int i = k; i < n; i++) a[i * ld + k] = T(0);
+      continue;
+    }
+    if (p != k) {
+      std::swap_ranges(a + k * ld, a + k * ld + n, a + p * ld);
+      std::swap(pivot_[k], pivot_[p]);
+      sign_ = -sign_;
+    }
+    const T *row_k = a + k * ld;
+    const T inv = T(1) / row_k[k];
+    const long rest = n - k - 1;
+    S21ThreadPool::ParallelFor(
+        k + 1, n, rest * rest, [=](long first, long last) {
+          for (long i = first; i < last; i++) {
+            T *row_i = a + i * ld;
+            T l = row_i[k] * inv;
+            row_i[k] = l;
+            if (l == T(0)) continue;
+            for (int j = k + 1; j < n; j++) row_i[j] -= l * row_k[j];
+          }
+        });
+  }
+}
+
+template <typename T>
+T S21BasicLU<T>::Determinant() const noexcept {
+  const int n = size();
+  const int ld = lu_.stride();
+  const T *a = lu_.data();
+  T det = T(sign_);
+  for (int i = 0; i < n; i++) det *= a[i * ld + i];
+  return det;
+}
+
+template <typename T>
+bool S21BasicLU<T>::IsInvertible() const noexcept {
+  // every pivot kept is above the relative threshold of the factorization
+  return !singular_;
+}
+
+template <typename T>
+S21BasicMatrix<T> S21BasicLU<T>::Solve(const Matrix &b) const {
+  const int n = size();
+  if (b.getRows() != n)
+    throw std::out_of_range(
+        "Incorrect input, right-hand side should have as many rows as A");
+  if (!IsInvertible()) throw std::out_of_range("Determinant = 0");
+  const int ld = lu_.stride();
+  const T *a = lu_.data();
+
+  const int m = b.getCols();
+  S21_STATS_SCOPE(kSolve, 2ULL * n * n * m);
+  Matrix x(n, m);
+  const int ldx = x.stride();
+  T *xd = x.data();
+  for (int i = 0; i < n; i++) {
+    std::copy_n(b.data() + pivot_[i] * b.stride(), m, xd + i * ldx);
+  }
+  // columns of the right-hand side are independent
+  auto substitute = [&](long j0, long j1) {
+    // L * y = P * b
+    for (int i = 1; i < n; i++) {
+      T *xi = xd + i * ldx;
+      for (int k = 0; k < i; k++) {
+        T l = a[i * ld + k];
+        if (l == T(0)) continue;
+        const T *xk = xd + k * ldx;
+        for (long j = j0; j < j1; j++) xi[j] -= l * xk[j];
+      }
+    }
+    // U * x = y
+    for (int i = n - 1; i >= 0; i--) {
+      T *xi = xd + i * ldx;
+      for (int k = i + 1; k < n; k++) {
+        T u = a[i * ld + k];
+        if (u == T(0)) continue;
+        const T *xk = xd + k * ldx;
+        for (long j = j0; j < j1; j++) xi[j] -= u * xk[j];
+      }
+      const T inv = T(1) / a[i * ld + i];
+      for (long j = j0; j < j1; j++) xi[j] *= inv;
+    }
+  };
+  S21ThreadPool::ParallelFor(0, m, static_cast<long>(n) * n * m, substitute);
+  return x;
+}
+
+template <typename T>
+S21BasicMatrix<T> S21BasicLU<T>::InverseMatrix() const {
+  const int n = size();
+  Matrix identity(n, n);
+  for (int i = 0; i < n; i++) identity(i, i) = T(1);
+  return Solve(identity);
+}
+
+template class S21BasicLU<float>;
+template class S21BasicLU<double>;
+template class S21BasicLU<long double>;
+template class S21BasicLU<std::complex<double>>;
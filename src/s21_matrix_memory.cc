@@ -0,0 +1,127 @@
+#include "s21_matrix_memory.h"
+
+#include <algorithm>
+#include <cstdint>
+
+namespace {
+
+thread_local std::pmr::memory_resource *current_resource = nullptr;
+
+std::size_t align_up(std::size_t value, std::size_t alignment) noexcept {
+  return (value + alignment - 1) / alignment * alignment;
+}
+
+}  // namespace
+
+std::pmr::memory_resource *S21CurrentResource() noexcept {
+  return current_resource ? current_resource
+                          : std::pmr::get_default_resource();
+}
+
+S21ScopedResource::S21ScopedResource(
+    std::pmr::memory_resource *resource) noexcept
+    : previous_(current_resource) {
+  current_resource = resource;
+}
+
+S21ScopedResource::~S21ScopedResource() { current_resource = previous_; }
+
+// Arena
+
+S21ArenaResource::S21ArenaResource(std::size_t initial_size,
+                                   std::pmr::memory_resource *upstream)
+    : upstream_(upstream),
+      next_size_(std::max<std::size_t>(initial_size, 1024)),
+      current_(nullptr),
+      left_(0),
+      allocated_(0) {}
+
+S21ArenaResource::~S21ArenaResource() { Release(); }
+
+void S21ArenaResource::Release() noexcept {
+  for (const Chunk &chunk : chunks_)
+    upstream_->deallocate(chunk.memory, chunk.size, alignof(std::max_align_t));
+  chunks_.clear();
+  current_ = nullptr;
+  left_ = 0;
+  allocated_ = 0;
+}
+
+void *S21ArenaResource::do_allocate(std::size_t bytes,
+                                    std::size_t alignment) {
+  auto address = reinterpret_cast<std::uintptr_t>(current_);
+  std::size_t padding = align_up(address, alignment) - address;
+  if (!current_ || padding + bytes > left_) {
+    std::size_t size = std::max(next_size_, bytes + alignment);
+    void *memory = upstream_->allocate(size, alignof(std::max_align_t));
+    chunks_.push_back({memory, size});
+    next_size_ = size * 2;
+    current_ = static_cast<char *>(memory);
+    left_ = size;
+    address = reinterpret_cast<std::uintptr_t>(current_);
+    padding = align_up(address, alignment) - address;
+  }
+  void *result = current_ + padding;
+  current_ += padding + bytes;
+  left_ -= padding + bytes;
+  allocated_ += bytes;
+  return result;
+}
+
+void S21ArenaResource::do_deallocate(void *, std::size_t, std::size_t) {}
+
+bool S21ArenaResource::do_is_equal(
+    const std::pmr::memory_resource &other) const noexcept {
+  return this == &other;
+}
+
+// Pool
+
+S21PoolResource::S21PoolResource(std::pmr::memory_resource *upstream)
+    : upstream_(upstream), free_(), chunks_(256 * 1024, upstream) {}
+
+void S21PoolResource::Release() noexcept {
+  std::fill(std::begin(free_), std::end(free_), nullptr);
+  chunks_.Release();
+}
+
+int S21PoolResource::size_class(std::size_t bytes) noexcept {
+  int index = 0;
+  std::size_t size = kMinPooled;
+  while (size < bytes) {
+    size *= 2;
+    index++;
+  }
+  return index;
+}
+
+void *S21PoolResource::do_allocate(std::size_t bytes, std::size_t alignment) {
+  if (bytes > kMaxPooled || alignment > kMinPooled)
+    return upstream_->allocate(bytes, alignment);
+  const int index = size_class(bytes);
+  if (FreeBlock *block = free_[index]) {
+    free_[index] = block->next;
+    return block;
+  }
+  // blocks are powers of two from a kMinPooled-aligned arena, so every
+  // block is aligned to kMinPooled
+  const std::size_t size = kMinPooled << index;
+  return chunks_.allocate(size, kMinPooled);
+}
+
+void S21PoolResource::do_deallocate(void *p, std::size_t bytes,
+                                    std::size_t alignment) {
+  if (bytes > kMaxPooled || alignment > kMinPooled) {
+    upstream_->deallocate(p, bytes, alignment);
+    return;
+  }
+  const int index = size_class(bytes);
+  auto *block = static_cast<FreeBlock *>(p);
+  block->next = free_[index];
+  free_[index] = block;
+}
+
+bool S21PoolResource::do_is_equal(
+    const std::pmr::memory_resource &other) const noexcept {
+  return this == &other;
+}
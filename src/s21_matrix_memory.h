@@ -0,0 +1,105 @@
+#ifndef MATRIX_SRC_S21_MATRIX_MEMORY_H
+#define MATRIX_SRC_S21_MATRIX_MEMORY_H
+
+#include <cstddef>
+#include <memory_resource>
+#include <vector>
+
+// Memory resources for matrix buffers. Matrices allocate through a
+// std::pmr::memory_resource: the one passed to their constructor, or else
+// the current resource of the calling thread, which S21ScopedResource can
+// redirect to an arena for a whole block of code.
+
+// Resource used by matrices created on this thread without an explicit one:
+// the innermost S21ScopedResource, or std::pmr::get_default_resource().
+[[nodiscard]] std::pmr::memory_resource *S21CurrentResource() noexcept;
+
+// Makes `resource` the current resource of this thread until destroyed.
+class S21ScopedResource {
+ private:
+  std::pmr::memory_resource *previous_;
+
+ public:
+  explicit S21ScopedResource(std::pmr::memory_resource *resource) noexcept;
+  S21ScopedResource(const S21ScopedResource &) = delete;
+  S21ScopedResource &operator=(const S21ScopedResource &) = delete;
+  ~S21ScopedResource();
+};
+
+// Bump allocator: hands out consecutive pieces of large chunks taken from
+// the upstream resource, deallocate() is a no-op and Release() drops
+// everything at once. Chunk sizes double as the arena grows. Not
+// thread-safe.
+class S21ArenaResource : public std::pmr::memory_resource {
+ private:
+  struct Chunk {
+    void *memory;
+    std::size_t size;
+  };
+
+  std::pmr::memory_resource *upstream_;
+  std::vector<Chunk> chunks_;
+  std::size_t next_size_;   // Size of the next chunk to request
+  char *current_;           // Free space of the newest chunk
+  std::size_t left_;        // Bytes left after current_
+  std::size_t allocated_;   // Bytes handed out since the last Release()
+
+  void *do_allocate(std::size_t bytes, std::size_t alignment) override;
+  void do_deallocate(void *p, std::size_t bytes,
+                     std::size_t alignment) override;
+  bool do_is_equal(
+      const std::pmr::memory_resource &other) const noexcept override;
+
+ public:
+  explicit S21ArenaResource(
+      std::size_t initial_size = 64 * 1024,
+      std::pmr::memory_resource *upstream = std::pmr::get_default_resource());
+  S21ArenaResource(const S21ArenaResource &) = delete;
+  S21ArenaResource &operator=(const S21ArenaResource &) = delete;
+  ~S21ArenaResource() override;
+
+  // Returns all chunks to upstream; every pointer from the arena dangles
+  void Release() noexcept;
+  [[nodiscard]] std::size_t getAllocated() const noexcept {
+    return allocated_;
+  }
+};
+
+// Size-class pool: requests up to kMaxPooled bytes are rounded up to a
+// power of two and served from per-class free lists, so freed buffers of
+// recurring matrix shapes are reused without touching upstream. Larger
+// requests go straight to upstream. Not thread-safe.
+class S21PoolResource : public std::pmr::memory_resource {
+ public:
+  static constexpr std::size_t kMinPooled = 64;
+  static constexpr std::size_t kMaxPooled = 64 * 1024;
+  static constexpr int kClasses = 11;  // 64 B .. 64 KiB
+
+ private:
+  struct FreeBlock {
+    FreeBlock *next;
+  };
+
+  std::pmr::memory_resource *upstream_;
+  FreeBlock *free_[kClasses];
+  S21ArenaResource chunks_;  // Backing storage of pooled blocks
+
+  [[nodiscard]] static int size_class(std::size_t bytes) noexcept;
+  void *do_allocate(std::size_t bytes, std::size_t alignment) override;
+  void do_deallocate(void *p, std::size_t bytes,
+                     std::size_t alignment) override;
+  bool do_is_equal(
+      const std::pmr::memory_resource &other) const noexcept override;
+
+ public:
+  explicit S21PoolResource(
+      std::pmr::memory_resource *upstream = std::pmr::get_default_resource());
+  S21PoolResource(const S21PoolResource &) = delete;
+  S21PoolResource &operator=(const S21PoolResource &) = delete;
+  ~S21PoolResource() override = default;
+
+  // Returns all pooled memory to upstream
+  void Release() noexcept;
+};
+
+#endif  // MATRIX_SRC_S21_MATRIX_MEMORY_H
@@ -1,62 +1,459 @@
 #ifndef MATRIX_SRC_S21_MATRIX_OOP_H
 #define MATRIX_SRC_S21_MATRIX_OOP_H
 
+#include <cassert>
+#include <cmath>
+#include <complex>
+#include <cstddef>
 #include <iostream>
+#include <memory_resource>
+#include <type_traits>
+#include <vector>
+
+#include "s21_matrix_expr.h"
+#include "s21_matrix_iterator.h"
+#include "s21_matrix_memory.h"
+#include "s21_thread_pool.h"
+
+// Per element type constants: the magnitude type returned by std::abs and
+// the tolerance used by EqMatrix and the singularity checks.
+template <typename T>
+struct S21ScalarTraits {
+  using real_type = T;
+  static constexpr real_type kMinimumDiff = static_cast<real_type>(1e-7);
+};
+
+template <>
+struct S21ScalarTraits<float> {
+  using real_type = float;
+  static constexpr real_type kMinimumDiff = 1e-5f;
+};
+
+template <typename R>
+struct S21ScalarTraits<std::complex<R>> {
+  using real_type = R;
+  static constexpr real_type kMinimumDiff = S21ScalarTraits<R>::kMinimumDiff;
+};
+
+template <typename T>
+class S21BasicLU;
+template <typename T>
+class S21BasicCholesky;
+template <typename T>
+class S21BasicQR;
+
+// Operand form for S21BasicMatrix::Multiply
+enum class S21Transpose { kNo, kYes };
+
+template <typename T>
+class S21BasicMatrix : public S21MatrixExpr<S21BasicMatrix<T>> {
+ public:
+  using value_type = T;
+  using real_type = typename S21ScalarTraits<T>::real_type;
 
-class S21Matrix {
  private:
   // Attributes
-  int rows_, cols_;  // Rows and columns
-  double **matrix_;  // Pointer to the memory where the matrix is allocated
+  int rows_, cols_;    // Rows and columns
+  int stride_;         // Leading dimension, also the column capacity
+  int row_capacity_;   // Rows the buffer has room for
+  T *matrix_;          // Row-major buffer of row_capacity_ * stride_ items
+  std::pmr::memory_resource *resource_;  // Source of matrix_
 
-  const float minimum_diff_ = 1e-7;
+  const real_type minimum_diff_ = S21ScalarTraits<T>::kMinimumDiff;
 
-  [[nodiscard]] S21Matrix minor(int m, int n) const;
-  [[nodiscard]] bool row_column_equal(const S21Matrix &A) const noexcept;
-  [[nodiscard]] double mnoj_matrix(const S21Matrix &A, int i,
-                                   int j) const noexcept;
-  [[nodiscard]] double determinant_out() const;
+  [[nodiscard]] S21BasicMatrix minor(int m, int n) const;
+  [[nodiscard]] bool row_column_equal(const S21BasicMatrix &A) const noexcept;
   void CreateMatrix();
-  void CopyMatrix(const S21Matrix &A);
-  void DeleteMatrix(S21Matrix &A) noexcept;
+  void Reallocate(int row_capacity, int stride);
+  void CopyMatrix(const S21BasicMatrix &A);
+  void DeleteMatrix(S21BasicMatrix &A) noexcept;
+  T *AllocateBuffer(std::size_t count) const;
+  void FreeBuffer(T *buffer, std::size_t count) const noexcept;
+  template <typename E>
+  void Evaluate(const E &expr);
+  [[noreturn]] static void throw_out_of_range(int i, int j);
 
  public:
-  S21Matrix() noexcept;
-  S21Matrix(int rows, int cols);
-  S21Matrix(const S21Matrix &other);
-  S21Matrix(S21Matrix &&other) noexcept;
-  ~S21Matrix();
+  // Alignment of the data buffer in bytes (one cache line)
+  static constexpr std::size_t kAlignment = 64;
+  static constexpr bool kExprLeaf = true;
+  // Default MultiplyStrassen() cutoff, near the crossover with Multiply()
+  static constexpr int kStrassenCutoff = 512;
 
-  [[nodiscard]] inline int getRows() const noexcept;
+  // Buffers come from `resource`, or from S21CurrentResource() when it is
+  // null. Copies allocate from the current resource; moves keep theirs.
+  S21BasicMatrix() noexcept;
+  explicit S21BasicMatrix(std::pmr::memory_resource *resource) noexcept;
+  S21BasicMatrix(int rows, int cols,
+                 std::pmr::memory_resource *resource = nullptr);
+  S21BasicMatrix(const S21BasicMatrix &other);
+  S21BasicMatrix(S21BasicMatrix &&other) noexcept;
+  template <typename E>
+  S21BasicMatrix(const S21MatrixExpr<E> &expr);
+  ~S21BasicMatrix();
+
+  // Resizing keeps the elements that remain in range and zeroes new ones.
+  // It only reallocates when the capacity is exceeded, and then grows the
+  // capacity geometrically, so appending rows one by one is amortized O(1)
+  // per element.
+  [[nodiscard]] int getRows() const noexcept;
   void setRows(int input);
   [[nodiscard]] int getCols() const noexcept;
   void setCols(int input);
+  // Room for rows x cols elements without reallocating; never shrinks
+  void reserve(int rows, int cols);
+  // Drops unused capacity, leaving a buffer of exactly rows x cols
+  void shrink_to_fit();
+  [[nodiscard]] int row_capacity() const noexcept { return row_capacity_; }
+  [[nodiscard]] int col_capacity() const noexcept { return stride_; }
+
+  // Raw storage: element (i, j) lives at data()[i * stride() + j]
+  [[nodiscard]] T *data() noexcept { return matrix_; }
+  [[nodiscard]] const T *data() const noexcept { return matrix_; }
+  [[nodiscard]] int stride() const noexcept { return stride_; }
+  [[nodiscard]] std::pmr::memory_resource *getResource() const noexcept {
+    return resource_;
+  }
+  // Unchecked element read used when evaluating expressions
+  [[nodiscard]] T eval(int i, int j) const noexcept {
+    return matrix_[static_cast<std::size_t>(i) * stride_ + j];
+  }
+  // A matrix owns its buffer, so it can only be the destination itself and
+  // then is read element for element
+  [[nodiscard]] bool aliases(const T *, long) const noexcept { return false; }
+
+  // Unchecked access for tight loops. Indices are only checked, with
+  // assert(), in builds without NDEBUG; operator() always checks.
+  [[nodiscard]] T &at_unchecked(int i, int j) noexcept {
+    assert(i >= 0 && i < rows_ && j >= 0 && j < cols_);
+    return matrix_[static_cast<std::size_t>(i) * stride_ + j];
+  }
+  [[nodiscard]] const T &at_unchecked(int i, int j) const noexcept {
+    assert(i >= 0 && i < rows_ && j >= 0 && j < cols_);
+    return matrix_[static_cast<std::size_t>(i) * stride_ + j];
+  }
+  // Row i as a contiguous span of getCols() elements
+  [[nodiscard]] S21Span<T> row(int i) noexcept {
+    assert(i >= 0 && i < rows_);
+    return S21Span<T>(matrix_ + static_cast<std::size_t>(i) * stride_, cols_);
+  }
+  [[nodiscard]] S21Span<const T> row(int i) const noexcept {
+    assert(i >= 0 && i < rows_);
+    return S21Span<const T>(matrix_ + static_cast<std::size_t>(i) * stride_,
+                            cols_);
+  }
+  // All rows, `for (auto row : m.rows())`
+  [[nodiscard]] S21RowRange<T> rows() noexcept {
+    return S21RowRange<T>(matrix_, rows_, cols_, stride_);
+  }
+  [[nodiscard]] S21RowRange<const T> rows() const noexcept {
+    return S21RowRange<const T>(matrix_, rows_, cols_, stride_);
+  }
+  // Elements in row-major order, skipping the unused capacity of each row
+  using iterator = S21ElementIterator<T>;
+  using const_iterator = S21ElementIterator<const T>;
+  [[nodiscard]] iterator begin() noexcept {
+    return iterator(matrix_, cols_, stride_);
+  }
+  [[nodiscard]] iterator end() noexcept {
+    return iterator(matrix_ + static_cast<std::size_t>(rows_) * stride_,
+                    cols_, stride_);
+  }
+  [[nodiscard]] const_iterator begin() const noexcept {
+    return const_iterator(matrix_, cols_, stride_);
+  }
+  [[nodiscard]] const_iterator end() const noexcept {
+    return const_iterator(
+        matrix_ + static_cast<std::size_t>(rows_) * stride_, cols_, stride_);
+  }
+
+  [[nodiscard]] bool EqMatrix(const S21BasicMatrix &other) const noexcept;
+  void SumMatrix(const S21BasicMatrix &other);
+  void SubMatrix(const S21BasicMatrix &other);
+  void MulNumber(const T num) noexcept;
+  void MulMatrix(const S21BasicMatrix &other);
+  // C = alpha * op(A) * op(B) + beta * C, where op(X) is X or X^T read in
+  // place. With beta == 0 C takes the product's shape and its contents are
+  // ignored; otherwise it must already have that shape. C may alias A or B.
+  static void Multiply(S21BasicMatrix &C, const S21BasicMatrix &A,
+                       const S21BasicMatrix &B, T alpha = T(1), T beta = T(0),
+                       S21Transpose trans_a = S21Transpose::kNo,
+                       S21Transpose trans_b = S21Transpose::kNo);
+  // C = A * B by the Strassen-Winograd recursion, which does fewer
+  // multiplications than Multiply() on large operands at the price of
+  // extra memory traffic and a somewhat larger rounding error. Recursion
+  // stops when a dimension is at most `cutoff`; from there on, and for
+  // the peeled odd rows and columns, Multiply()'s kernel is used. C takes
+  // the product's shape and may alias A or B.
+  static void MultiplyStrassen(S21BasicMatrix &C, const S21BasicMatrix &A,
+                               const S21BasicMatrix &B,
+                               int cutoff = kStrassenCutoff);
+  [[nodiscard]] S21BasicMatrix Transpose() const;
+  // Transposes a square matrix by swapping mirrored blocks, without a
+  // second buffer; other shapes are transposed through a new buffer
+  void TransposeInPlace();
+  // Cofactors, det(A) * A^-T from one LU factorization; for a singular A
+  // every minor's determinant is computed instead, in parallel
+  [[nodiscard]] S21BasicMatrix CalcComplements() const;
+  [[nodiscard]] T Determinant() const;
+  [[nodiscard]] S21BasicMatrix InverseMatrix() const;
+  // Factorizations to keep when solving against the same matrix many times
+  [[nodiscard]] S21BasicLU<T> LU() const;
+  [[nodiscard]] S21BasicCholesky<T> Cholesky() const;
+  [[nodiscard]] S21BasicQR<T> QR() const;
+  // X with A * X = b for every column of b: through LU for a square A, in
+  // the least squares sense through QR for a tall one
+  [[nodiscard]] S21BasicMatrix Solve(const S21BasicMatrix &b) const;
+
+  S21BasicMatrix operator*(const S21BasicMatrix &A) const;
+  bool operator==(const S21BasicMatrix &A) const noexcept;
+  bool operator!=(const S21BasicMatrix &A) const noexcept;
+  S21BasicMatrix &operator=(const S21BasicMatrix &A);
+  // Steals A's buffer when both share a resource, copies otherwise
+  S21BasicMatrix &operator=(S21BasicMatrix &&A);
+  template <typename E>
+  S21BasicMatrix &operator=(const S21MatrixExpr<E> &expr);
+  S21BasicMatrix operator+=(const S21BasicMatrix &A);
+  S21BasicMatrix operator-=(const S21BasicMatrix &A);
+  S21BasicMatrix operator*=(const S21BasicMatrix &A);
+  S21BasicMatrix operator*=(const T number) noexcept;
+  template <typename E>
+  S21BasicMatrix &operator+=(const S21MatrixExpr<E> &expr);
+  template <typename E>
+  S21BasicMatrix &operator-=(const S21MatrixExpr<E> &expr);
+  // Checked access, throws std::out_of_range
+  T &operator()(int i, int j) {
+    if (i < 0 || i >= rows_ || j < 0 || j >= cols_) throw_out_of_range(i, j);
+    return matrix_[static_cast<std::size_t>(i) * stride_ + j];
+  }
+  const T &operator()(int i, int j) const {
+    if (i < 0 || i >= rows_ || j < 0 || j >= cols_) throw_out_of_range(i, j);
+    return matrix_[static_cast<std::size_t>(i) * stride_ + j];
+  }
+};
+
+using S21Matrix = S21BasicMatrix<double>;
+using S21MatrixF = S21BasicMatrix<float>;
+using S21MatrixLD = S21BasicMatrix<long double>;
+using S21MatrixCD = S21BasicMatrix<std::complex<double>>;
+
+// Expression evaluation
+
+template <typename T>
+template <typename E>
+S21BasicMatrix<T>::S21BasicMatrix(const S21MatrixExpr<E> &expr)
+    : rows_(0),
+      cols_(0),
+      stride_(0),
+      row_capacity_(0),
+      matrix_(nullptr),
+      resource_(S21CurrentResource()) {
+  *this = expr;
+}
+
+template <typename T>
+template <typename E>
+void S21BasicMatrix<T>::Evaluate(const E &expr) {
+  const long cost = static_cast<long>(rows_) * cols_;
+  S21ThreadPool::ParallelFor(0, rows_, cost, [&](long first, long last) {
+    for (long i = first; i < last; i++) {
+      T *row = matrix_ + i * stride_;
+      const int n = cols_;
+      const int r = static_cast<int>(i);
+      for (int j = 0; j < n; j++) row[j] = expr.eval(r, j);
+    }
+  });
+}
+
+template <typename T>
+template <typename E>
+S21BasicMatrix<T> &S21BasicMatrix<T>::operator=(
+    const S21MatrixExpr<E> &expr) {
+  static_assert(std::is_same_v<typename E::value_type, T>,
+                "Expression and matrix element types should match");
+  const E &e = expr.self();
+  if (matrix_ && rows_ == e.getRows() && cols_ == e.getCols() &&
+      !e.aliases(matrix_, stride_)) {
+    // *this may still appear in the expression, it is read element for
+    // element; a view that reaches other elements of it goes below
+    Evaluate(e);
+  } else if (e.getRows() > 0 && e.getCols() > 0) {
+    S21BasicMatrix sol(e.getRows(), e.getCols(), resource_);
+    sol.Evaluate(e);
+    *this = std::move(sol);
+  } else {
+    *this = S21BasicMatrix(resource_);
+  }
+  return *this;
+}
+
+template <typename T>
+template <typename E>
+S21BasicMatrix<T> &S21BasicMatrix<T>::operator+=(
+    const S21MatrixExpr<E> &expr) {
+  return *this = *this + expr;
+}
+
+template <typename T>
+template <typename E>
+S21BasicMatrix<T> &S21BasicMatrix<T>::operator-=(
+    const S21MatrixExpr<E> &expr) {
+  return *this = *this - expr;
+}
+
+// Operators with a stored matrix on the left are the members above, these
+// cover a pending expression or a view on the left. Comparison reads the
+// elements in place; products are not element-wise, both operands are
+// materialized first.
+template <typename L, typename R, std::enable_if_t<!L::kExprLeaf, int> = 0>
+S21BasicMatrix<typename L::value_type> operator*(
+    const S21MatrixExpr<L> &left, const S21MatrixExpr<R> &right) {
+  using Matrix = S21BasicMatrix<typename L::value_type>;
+  return Matrix(left) * Matrix(right);
+}
+
+template <typename L, typename R, std::enable_if_t<!L::kExprLeaf, int> = 0>
+bool operator==(const S21MatrixExpr<L> &left, const S21MatrixExpr<R> &right) {
+  using Traits = S21ScalarTraits<typename L::value_type>;
+  const L &l = left.self();
+  const R &r = right.self();
+  if (l.getRows() != r.getRows() || l.getCols() != r.getCols()) return false;
+  for (int i = 0; i < l.getRows(); i++) {
+    for (int j = 0; j < l.getCols(); j++) {
+      if (std::abs(l.eval(i, j) - r.eval(i, j)) >= Traits::kMinimumDiff)
+        return false;
+    }
+  }
+  return true;
+}
+
+template <typename L, typename R, std::enable_if_t<!L::kExprLeaf, int> = 0>
+bool operator!=(const S21MatrixExpr<L> &left, const S21MatrixExpr<R> &right) {
+  return !(left == right);
+}
+
+// LU factorization with partial pivoting: P * A = L * U.
+// L (unit diagonal) and U are packed into one matrix, the row permutation is
+// kept as a pivot vector, so the factorization can be reused for several
+// right-hand sides.
+template <typename T>
+class S21BasicLU {
+ public:
+  using Matrix = S21BasicMatrix<T>;
+  using real_type = typename Matrix::real_type;
+
+ private:
+  Matrix lu_;               // L below the diagonal, U on and above it
+  std::vector<int> pivot_;  // pivot_[i] is the source row of row i
+  int sign_;                // Parity of the permutation (+1 or -1)
+  bool singular_;           // A pivot at round-off level was met
+
+ public:
+  explicit S21BasicLU(const Matrix &A);
+  // Factorizes in A's buffer instead of a copy
+  explicit S21BasicLU(Matrix &&A);
+
+  [[nodiscard]] int size() const noexcept { return lu_.getRows(); }
+  [[nodiscard]] bool IsSingular() const noexcept { return singular_; }
+  // No pivot is at or below n * epsilon times the largest element of A, so
+  // Solve() and InverseMatrix() succeed; the scale of A does not matter
+  [[nodiscard]] bool IsInvertible() const noexcept;
+  [[nodiscard]] const Matrix &Factors() const noexcept { return lu_; }
+  [[nodiscard]] const std::vector<int> &Pivots() const noexcept {
+    return pivot_;
+  }
+
+  [[nodiscard]] T Determinant() const noexcept;
+  [[nodiscard]] Matrix Solve(const Matrix &b) const;
+  [[nodiscard]] Matrix InverseMatrix() const;
+};
+
+using S21LU = S21BasicLU<double>;
+
+// Cholesky factorization of a Hermitian positive definite matrix:
+// A = U^H * U with U upper triangular. Only the upper triangle of A is
+// read. It takes half the work of LU and needs no pivoting; a matrix that
+// turns out not to be positive definite is flagged and cannot be solved.
+template <typename T>
+class S21BasicCholesky {
+ public:
+  using Matrix = S21BasicMatrix<T>;
+  using real_type = typename Matrix::real_type;
+
+ private:
+  Matrix u_;                // U on and above the diagonal, A's rest below
+  bool positive_definite_;
+
+ public:
+  explicit S21BasicCholesky(const Matrix &A);
+  // Factorizes in A's buffer instead of a copy
+  explicit S21BasicCholesky(Matrix &&A);
+
+  [[nodiscard]] int size() const noexcept { return u_.getRows(); }
+  [[nodiscard]] bool IsPositiveDefinite() const noexcept {
+    return positive_definite_;
+  }
+  [[nodiscard]] const Matrix &Factors() const noexcept { return u_; }
+
+  [[nodiscard]] T Determinant() const noexcept;
+  [[nodiscard]] Matrix Solve(const Matrix &b) const;
+  [[nodiscard]] Matrix InverseMatrix() const;
+};
+
+using S21Cholesky = S21BasicCholesky<double>;
+
+// Householder QR factorization of a matrix with at least as many rows as
+// columns: A = Q * R. As in LAPACK, the reflectors are kept below the
+// diagonal of R with their scales in a vector, so Q is applied without
+// being formed. Solve() gives the least squares solution, the exact one
+// for a square A.
+template <typename T>
+class S21BasicQR {
+ public:
+  using Matrix = S21BasicMatrix<T>;
+  using real_type = typename Matrix::real_type;
 
-  [[nodiscard]] bool EqMatrix(const S21Matrix &other) const noexcept;
-  void SumMatrix(const S21Matrix &other);
-  void SubMatrix(const S21Matrix &other);
-  void MulNumber(const double num) noexcept;
-  void MulMatrix(const S21Matrix &other);
-  [[nodiscard]] S21Matrix Transpose() const;
-  [[nodiscard]] S21Matrix CalcComplements() const;
-  [[nodiscard]] double Determinant() const;
-  [[nodiscard]] S21Matrix InverseMatrix() const;
-
-  S21Matrix operator+(const S21Matrix &A) const;
-  S21Matrix operator-(const S21Matrix &A) const;
-  S21Matrix operator*(const double number) const noexcept;
-  S21Matrix operator*(const S21Matrix &A) const;
-  bool operator==(const S21Matrix &A) const noexcept;
-  bool operator!=(const S21Matrix &A) const noexcept;
-  S21Matrix &operator=(S21Matrix &A);
-  S21Matrix &operator=(S21Matrix &&A) noexcept;
-  S21Matrix operator+=(const S21Matrix &A);
-  S21Matrix operator-=(const S21Matrix &A);
-  S21Matrix operator*=(const S21Matrix &A);
-  S21Matrix operator*=(const double number) noexcept;
-  double &operator()(int i, int j);
-  const double &operator()(int i, int j) const;
-  friend S21Matrix operator*(const double num, const S21Matrix &A) noexcept;
+ private:
+  Matrix qr_;            // R on and above the diagonal, reflectors below
+  std::vector<T> tau_;   // Scale of each reflector
+  bool rank_deficient_;  // A zero on R's diagonal
+
+ public:
+  explicit S21BasicQR(const Matrix &A);
+  // Factorizes in A's buffer instead of a copy
+  explicit S21BasicQR(Matrix &&A);
+
+  [[nodiscard]] int getRows() const noexcept { return qr_.getRows(); }
+  [[nodiscard]] int getCols() const noexcept { return qr_.getCols(); }
+  [[nodiscard]] bool IsRankDeficient() const noexcept {
+    return rank_deficient_;
+  }
+  [[nodiscard]] const Matrix &Factors() const noexcept { return qr_; }
+
+  // The first getCols() columns of Q
+  [[nodiscard]] Matrix Q() const;
+  [[nodiscard]] Matrix R() const;
+  [[nodiscard]] Matrix Solve(const Matrix &b) const;
 };
 
-#endif  // MATRIX_SRC_S21_MATRIX_OOP_H
\ No newline at end of file
+using S21QR = S21BasicQR<double>;
+
+// Instantiated once in the library for these element types
+extern template class S21BasicMatrix<float>;
+extern template class S21BasicMatrix<double>;
+extern template class S21BasicMatrix<long double>;
+extern template class S21BasicMatrix<std::complex<double>>;
+extern template class S21BasicLU<float>;
+extern template class S21BasicLU<double>;
+extern template class S21BasicLU<long double>;
+extern template class S21BasicLU<std::complex<double>>;
+extern template class S21BasicCholesky<float>;
+extern template class S21BasicCholesky<double>;
+extern template class S21BasicCholesky<long double>;
+extern template class S21BasicCholesky<std::complex<double>>;
+extern template class S21BasicQR<float>;
+extern template class S21BasicQR<double>;
+extern template class S21BasicQR<long double>;
+extern template class S21BasicQR<std::complex<double>>;
+
+#endif  // MATRIX_SRC_S21_MATRIX_OOP_H
@@ -0,0 +1,499 @@
+// Vector kernels. Every operation has a scalar version plus AVX2 and
+// AVX-512 versions compiled through target attributes, so the library
+// needs no -march flag; the fastest one the CPU supports is chosen once
+// and cached in a function table.
+
+#include <immintrin.h>
+
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+#include "s21_matrix_kernels.h"
+
+namespace s21 {
+
+namespace {
+
+struct KernelTable {
+  SimdLevel level;
+  void (*add)(double *, const double *, long);
+  void (*sub)(double *, const double *, long);
+  void (*add3)(double *, const double *, const double *, long);
+  void (*sub3)(double *, const double *, const double *, long);
+  void (*scale)(double *, double, long);
+  void (*axpy)(double *, double, const double *, long);
+  void (*rot)(double *, double *, double, double, long);
+  bool (*equal)(const double *, const double *, long, double);
+  void (*transpose)(int, int, const double *, long, double *, long);
+  void (*micro_kernel)(int, double, const double *, const double *, double *,
+                       long, int, int);
+};
+
+// Scalar fallback
+
+void add_scalar(double *a, const double *b, long n) {
+  for (long i = 0; i < n; i++) a[i] += b[i];
+}
+
+void sub_scalar(double *a, const double *b, long n) {
+  for (long i = 0; i < n; i++) a[i] -= b[i];
+}
+
+void add3_scalar(double *c, const double *a, const double *b, long n) {
+  for (long i = 0; i < n; i++) c[i] = a[i] + b[i];
+}
+
+void sub3_scalar(double *c, const double *a, const double *b, long n) {
+  for (long i = 0; i < n; i++) c[i] = a[i] - b[i];
+}
+
+void scale_scalar(double *a, double s, long n) {
+  for (long i = 0; i < n; i++) a[i] *= s;
+}
+
+void axpy_scalar(double *y, double alpha, const double *x, long n) {
+  for (long i = 0; i < n; i++) y[i] += alpha * x[i];
+}
+
+void rot_scalar(double *x, double *y, double c, double s, long n) {
+  for (long i = 0; i < n; i++) {
+    const double xi = x[i];
+    x[i] = c * xi + s * y[i];
+    y[i] = c * y[i] - s * xi;
+  }
+}
+
+bool equal_scalar(const double *a, const double *b, long n, double tol) {
+  for (long i = 0; i < n; i++) {
+    if (std::abs(a[i] - b[i]) >= tol) return false;
+  }
+  return true;
+}
+
+void transpose_scalar(int rows, int cols, const double *a, long lda,
+                      double *b, long ldb) {
+  for (int i = 0; i < rows; i++)
+    for (int j = 0; j < cols; j++) b[j * ldb + i] = a[i * lda + j];
+}
+
+void micro_kernel_scalar(int kc, double alpha, const double *a,
+                         const double *b, double *c, long ldc, int mr,
+                         int nr) {
+  double acc[kGemmMr][kGemmNr] = {};
+  for (int p = 0; p < kc; p++) {
+    for (int i = 0; i < kGemmMr; i++) {
+      const double ai = a[i];
+      for (int j = 0; j < kGemmNr; j++) acc[i][j] += ai * b[j];
+    }
+    a += kGemmMr;
+    b += kGemmNr;
+  }
+  for (int i = 0; i < mr; i++) {
+    double *ci = c + i * ldc;
+    for (int j = 0; j < nr; j++) ci[j] += alpha * acc[i][j];
+  }
+}
+
+// AVX2 + FMA
+
+__attribute__((target("avx2,fma"))) void add_avx2(double *a, const double *b,
+                                                  long n) {
+  long i = 0;
+  for (; i + 4 <= n; i += 4)
+    _mm256_storeu_pd(a + i, _mm256_add_pd(_mm256_loadu_pd(a + i),
+                                          _mm256_loadu_pd(b + i)));
+  for (; i < n; i++) a[i] += b[i];
+}
+
+__attribute__((target("avx2,fma"))) void sub_avx2(double *a, const double *b,
+                                                  long n) {
+  long i = 0;
+  for (; i + 4 <= n; i += 4)
+    _mm256_storeu_pd(a + i, _mm256_sub_pd(_mm256_loadu_pd(a + i),
+                                          _mm256_loadu_pd(b + i)));
+  for (; i < n; i++) a[i] -= b[i];
+}
+
+__attribute__((target("avx2,fma"))) void add3_avx2(double *c, const double *a,
+                                                   const double *b, long n) {
+  long i = 0;
+  for (; i + 4 <= n; i += 4)
+    _mm256_storeu_pd(c + i, _mm256_add_pd(_mm256_loadu_pd(a + i),
+                                          _mm256_loadu_pd(b + i)));
+  for (; i < n; i++) c[i] = a[i] + b[i];
+}
+
+__attribute__((target("avx2,fma"))) void sub3_avx2(double *c, const double *a,
+                                                   const double *b, long n) {
+  long i = 0;
+  for (; i + 4 <= n; i += 4)
+    _mm256_storeu_pd(c + i, _mm256_sub_pd(_mm256_loadu_pd(a + i),
+                                          _mm256_loadu_pd(b + i)));
+  for (; i < n; i++) c[i] = a[i] - b[i];
+}
+
+__attribute__((target("avx2,fma"))) void scale_avx2(double *a, double s,
+                                                    long n) {
+  const __m256d vs = _mm256_set1_pd(s);
+  long i = 0;
+  for (; i + 4 <= n; i += 4)
+    _mm256_storeu_pd(a + i, _mm256_mul_pd(_mm256_loadu_pd(a + i), vs));
+  for (; i < n; i++) a[i] *= s;
+}
+
+__attribute__((target("avx2,fma"))) void axpy_avx2(double *y, double alpha,
+                                                   const double *x, long n) {
+  const __m256d va = _mm256_set1_pd(alpha);
+  long i = 0;
+  for (; i + 4 <= n; i += 4)
+    _mm256_storeu_pd(y + i, _mm256_fmadd_pd(va, _mm256_loadu_pd(x + i),
+                                            _mm256_loadu_pd(y + i)));
+  for (; i < n; i++) y[i] += alpha * x[i];
+}
+
+__attribute__((target("avx2,fma"))) void rot_avx2(double *x, double *y,
+                                                  double c, double s,
+                                                  long n) {
+  const __m256d vc = _mm256_set1_pd(c), vs = _mm256_set1_pd(s);
+  long i = 0;
+  for (; i + 4 <= n; i += 4) {
+    const __m256d xi = _mm256_loadu_pd(x + i), yi = _mm256_loadu_pd(y + i);
+    _mm256_storeu_pd(x + i, _mm256_fmadd_pd(vc, xi, _mm256_mul_pd(vs, yi)));
+    _mm256_storeu_pd(y + i, _mm256_fmsub_pd(vc, yi, _mm256_mul_pd(vs, xi)));
+  }
+  rot_scalar(x + i, y + i, c, s, n - i);
+}
+
+__attribute__((target("avx2,fma"))) bool equal_avx2(const double *a,
+                                                    const double *b, long n,
+                                                    double tol) {
+  const __m256d sign = _mm256_set1_pd(-0.0);
+  const __m256d vtol = _mm256_set1_pd(tol);
+  long i = 0;
+  for (; i + 4 <= n; i += 4) {
+    __m256d diff =
+        _mm256_sub_pd(_mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i));
+    __m256d ge = _mm256_cmp_pd(_mm256_andnot_pd(sign, diff), vtol, _CMP_GE_OQ);
+    if (_mm256_movemask_pd(ge)) return false;
+  }
+  return equal_scalar(a + i, b + i, n - i, tol);
+}
+
+// Transposes one 4x4 block held in four row registers
+__attribute__((target("avx2,fma"))) void transpose_block_avx2(
+    const double *a, long lda, double *b, long ldb) {
+  __m256d r0 = _mm256_loadu_pd(a);
+  __m256d r1 = _mm256_loadu_pd(a + lda);
+  __m256d r2 = _mm256_loadu_pd(a + 2 * lda);
+  __m256d r3 = _mm256_loadu_pd(a + 3 * lda);
+  __m256d t0 = _mm256_unpacklo_pd(r0, r1);
+  __m256d t1 = _mm256_unpackhi_pd(r0, r1);
+  __m256d t2 = _mm256_unpacklo_pd(r2, r3);
+  __m256d t3 = _mm256_unpackhi_pd(r2, r3);
+  _mm256_storeu_pd(b, _mm256_permute2f128_pd(t0, t2, 0x20));
+  _mm256_storeu_pd(b + ldb, _mm256_permute2f128_pd(t1, t3, 0x20));
+  _mm256_storeu_pd(b + 2 * ldb, _mm256_permute2f128_pd(t0, t2, 0x31));
+  _mm256_storeu_pd(b + 3 * ldb, _mm256_permute2f128_pd(t1, t3, 0x31));
+}
+
+__attribute__((target("avx2,fma"))) void transpose_avx2(int rows, int cols,
+                                                        const double *a,
+                                                        long lda, double *b,
+                                                        long ldb) {
+  const int rows4 = rows & ~3, cols4 = cols & ~3;
+  for (int i = 0; i < rows4; i += 4) {
+    for (int j = 0; j < cols4; j += 4)
+      transpose_block_avx2(a + i * lda + j, lda, b + j * ldb + i, ldb);
+    for (int j = cols4; j < cols; j++)
+      for (int ii = i; ii < i + 4; ii++) b[j * ldb + ii] = a[ii * lda + j];
+  }
+  for (int i = rows4; i < rows; i++)
+    for (int j = 0; j < cols; j++) b[j * ldb + i] = a[i * lda + j];
+}
+
+// 4x8 tile kept in eight ymm accumulators
+__attribute__((target("avx2,fma"))) void micro_kernel_avx2(
+    int kc, double alpha, const double *a, const double *b, double *c,
+    long ldc, int mr, int nr) {
+  static_assert(kGemmMr == 4 && kGemmNr == 8, "tile shape of the kernel");
+  __m256d c00 = _mm256_setzero_pd(), c01 = _mm256_setzero_pd();
+  __m256d c10 = _mm256_setzero_pd(), c11 = _mm256_setzero_pd();
+  __m256d c20 = _mm256_setzero_pd(), c21 = _mm256_setzero_pd();
+  __m256d c30 = _mm256_setzero_pd(), c31 = _mm256_setzero_pd();
+  for (int p = 0; p < kc; p++) {
+    const __m256d b0 = _mm256_loadu_pd(b);
+    const __m256d b1 = _mm256_loadu_pd(b + 4);
+    __m256d ai = _mm256_broadcast_sd(a);
+    c00 = _mm256_fmadd_pd(ai, b0, c00);
+    c01 = _mm256_fmadd_pd(ai, b1, c01);
+    ai = _mm256_broadcast_sd(a + 1);
+    c10 = _mm256_fmadd_pd(ai, b0, c10);
+    c11 = _mm256_fmadd_pd(ai, b1, c11);
+    ai = _mm256_broadcast_sd(a + 2);
+    c20 = _mm256_fmadd_pd(ai, b0, c20);
+    c21 = _mm256_fmadd_pd(ai, b1, c21);
+    ai = _mm256_broadcast_sd(a + 3);
+    c30 = _mm256_fmadd_pd(ai, b0, c30);
+    c31 = _mm256_fmadd_pd(ai, b1, c31);
+    a += kGemmMr;
+    b += kGemmNr;
+  }
+  alignas(32) double acc[kGemmMr][kGemmNr];
+  const __m256d va = _mm256_set1_pd(alpha);
+  _mm256_store_pd(acc[0], _mm256_mul_pd(va, c00));
+  _mm256_store_pd(acc[0] + 4, _mm256_mul_pd(va, c01));
+  _mm256_store_pd(acc[1], _mm256_mul_pd(va, c10));
+  _mm256_store_pd(acc[1] + 4, _mm256_mul_pd(va, c11));
+  _mm256_store_pd(acc[2], _mm256_mul_pd(va, c20));
+  _mm256_store_pd(acc[2] + 4, _mm256_mul_pd(va, c21));
+  _mm256_store_pd(acc[3], _mm256_mul_pd(va, c30));
+  _mm256_store_pd(acc[3] + 4, _mm256_mul_pd(va, c31));
+  if (mr == kGemmMr && nr == kGemmNr) {
+    for (int i = 0; i < kGemmMr; i++) {
+      double *ci = c + i * ldc;
+      _mm256_storeu_pd(ci, _mm256_add_pd(_mm256_loadu_pd(ci),
+                                         _mm256_load_pd(acc[i])));
+      _mm256_storeu_pd(ci + 4, _mm256_add_pd(_mm256_loadu_pd(ci + 4),
+                                             _mm256_load_pd(acc[i] + 4)));
+    }
+  } else {
+    for (int i = 0; i < mr; i++)
+      for (int j = 0; j < nr; j++) c[i * ldc + j] += acc[i][j];
+  }
+}
+
+// AVX-512: eight lanes, the fringe is handled with a lane mask
+
+__attribute__((target("avx512f"))) void add_avx512(double *a, const double *b,
+                                                   long n) {
+  long i = 0;
+  for (; i + 8 <= n; i += 8)
+    _mm512_storeu_pd(a + i, _mm512_add_pd(_mm512_loadu_pd(a + i),
+                                          _mm512_loadu_pd(b + i)));
+  if (i < n) {
+    const __mmask8 m = static_cast<__mmask8>((1u << (n - i)) - 1);
+    _mm512_mask_storeu_pd(a + i, m,
+                          _mm512_add_pd(_mm512_maskz_loadu_pd(m, a + i),
+                                        _mm512_maskz_loadu_pd(m, b + i)));
+  }
+}
+
+__attribute__((target("avx512f"))) void sub_avx512(double *a, const double *b,
+                                                   long n) {
+  long i = 0;
+  for (; i + 8 <= n; i += 8)
+    _mm512_storeu_pd(a + i, _mm512_sub_pd(_mm512_loadu_pd(a + i),
+                                          _mm512_loadu_pd(b + i)));
+  if (i < n) {
+    const __mmask8 m = static_cast<__mmask8>((1u << (n - i)) - 1);
+    _mm512_mask_storeu_pd(a + i, m,
+                          _mm512_sub_pd(_mm512_maskz_loadu_pd(m, a + i),
+                                        _mm512_maskz_loadu_pd(m, b + i)));
+  }
+}
+
+__attribute__((target("avx512f"))) void add3_avx512(double *c,
+                                                    const double *a,
+                                                    const double *b, long n) {
+  long i = 0;
+  for (; i + 8 <= n; i += 8)
+    _mm512_storeu_pd(c + i, _mm512_add_pd(_mm512_loadu_pd(a + i),
+                                          _mm512_loadu_pd(b + i)));
+  if (i < n) {
+    const __mmask8 m = static_cast<__mmask8>((1u << (n - i)) - 1);
+    _mm512_mask_storeu_pd(c + i, m,
+                          _mm512_add_pd(_mm512_maskz_loadu_pd(m, a + i),
+                                        _mm512_maskz_loadu_pd(m, b + i)));
+  }
+}
+
+__attribute__((target("avx512f"))) void sub3_avx512(double *c,
+                                                    const double *a,
+                                                    const double *b, long n) {
+  long i = 0;
+  for (; i + 8 <= n; i += 8)
+    _mm512_storeu_pd(c + i, _mm512_sub_pd(_mm512_loadu_pd(a + i),
+                                          _mm512_loadu_pd(b + i)));
+  if (i < n) {
+    const __mmask8 m = static_cast<__mmask8>((1u << (n - i)) - 1);
+    _mm512_mask_storeu_pd(c + i, m,
+                          _mm512_sub_pd(_mm512_maskz_loadu_pd(m, a + i),
+                                        _mm512_maskz_loadu_pd(m, b + i)));
+  }
+}
+
+__attribute__((target("avx512f"))) void scale_avx512(double *a, double s,
+                                                     long n) {
+  const __m512d vs = _mm512_set1_pd(s);
+  long i = 0;
+  for (; i + 8 <= n; i += 8)
+    _mm512_storeu_pd(a + i, _mm512_mul_pd(_mm512_loadu_pd(a + i), vs));
+  if (i < n) {
+    const __mmask8 m = static_cast<__mmask8>((1u << (n - i)) - 1);
+    _mm512_mask_storeu_pd(a + i, m,
+                          _mm512_mul_pd(_mm512_maskz_loadu_pd(m, a + i), vs));
+  }
+}
+
+__attribute__((target("avx512f"))) void axpy_avx512(double *y, double alpha,
+                                                    const double *x, long n) {
+  const __m512d va = _mm512_set1_pd(alpha);
+  long i = 0;
+  for (; i + 8 <= n; i += 8)
+    _mm512_storeu_pd(y + i, _mm512_fmadd_pd(va, _mm512_loadu_pd(x + i),
+                                            _mm512_loadu_pd(y + i)));
+  if (i < n) {
+    const __mmask8 m = static_cast<__mmask8>((1u << (n - i)) - 1);
+    _mm512_mask_storeu_pd(
+        y + i, m,
+        _mm512_fmadd_pd(va, _mm512_maskz_loadu_pd(m, x + i),
+                        _mm512_maskz_loadu_pd(m, y + i)));
+  }
+}
+
+__attribute__((target("avx512f"))) void rot_avx512(double *x, double *y,
+                                                   double c, double s,
+                                                   long n) {
+  const __m512d vc = _mm512_set1_pd(c), vs = _mm512_set1_pd(s);
+  long i = 0;
+  for (; i + 8 <= n; i += 8) {
+    const __m512d xi = _mm512_loadu_pd(x + i), yi = _mm512_loadu_pd(y + i);
+    _mm512_storeu_pd(x + i, _mm512_fmadd_pd(vc, xi, _mm512_mul_pd(vs, yi)));
+    _mm512_storeu_pd(y + i, _mm512_fmsub_pd(vc, yi, _mm512_mul_pd(vs, xi)));
+  }
+  if (i < n) {
+    const __mmask8 m = static_cast<__mmask8>((1u << (n - i)) - 1);
+    const __m512d xi = _mm512_maskz_loadu_pd(m, x + i);
+    const __m512d yi = _mm512_maskz_loadu_pd(m, y + i);
+    _mm512_mask_storeu_pd(x + i, m,
+                          _mm512_fmadd_pd(vc, xi, _mm512_mul_pd(vs, yi)));
+    _mm512_mask_storeu_pd(y + i, m,
+                          _mm512_fmsub_pd(vc, yi, _mm512_mul_pd(vs, xi)));
+  }
+}
+
+__attribute__((target("avx512f"))) bool equal_avx512(const double *a,
+                                                     const double *b, long n,
+                                                     double tol) {
+  const __m512d vtol = _mm512_set1_pd(tol);
+  long i = 0;
+  for (; i + 8 <= n; i += 8) {
+    __m512d diff = _mm512_abs_pd(
+        _mm512_sub_pd(_mm512_loadu_pd(a + i), _mm512_loadu_pd(b + i)));
+    if (_mm512_cmp_pd_mask(diff, vtol, _CMP_GE_OQ)) return false;
+  }
+  if (i < n) {
+    const __mmask8 m = static_cast<__mmask8>((1u << (n - i)) - 1);
+    __m512d diff = _mm512_abs_pd(_mm512_sub_pd(
+        _mm512_maskz_loadu_pd(m, a + i), _mm512_maskz_loadu_pd(m, b + i)));
+    if (_mm512_mask_cmp_pd_mask(m, diff, vtol, _CMP_GE_OQ)) return false;
+  }
+  return true;
+}
+
+// S21_MATRIX_SIMD=scalar|avx2 caps the level, e.g. to compare kernels
+bool level_allowed(const char *name) {
+  static const char *const kOrder[] = {"scalar", "avx2", "avx512"};
+  const char *cap = std::getenv("S21_MATRIX_SIMD");
+  if (!cap) return true;
+  int cap_rank = 2, rank = 0;
+  for (int i = 0; i < 3; i++) {
+    if (std::strcmp(cap, kOrder[i]) == 0) cap_rank = i;
+    if (std::strcmp(name, kOrder[i]) == 0) rank = i;
+  }
+  return rank <= cap_rank;
+}
+
+KernelTable select_kernels() {
+  __builtin_cpu_init();
+  KernelTable table = {SimdLevel::kScalar, add_scalar,   sub_scalar,
+                       add3_scalar,        sub3_scalar,  scale_scalar,
+                       axpy_scalar,        rot_scalar,   equal_scalar,
+                       transpose_scalar,   micro_kernel_scalar};
+  if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma") &&
+      level_allowed("avx2")) {
+    table = {SimdLevel::kAvx2, add_avx2,       sub_avx2,   add3_avx2,
+             sub3_avx2,        scale_avx2,     axpy_avx2,  rot_avx2,
+             equal_avx2,       transpose_avx2, micro_kernel_avx2};
+  }
+  if (__builtin_cpu_supports("avx512f") && table.level == SimdLevel::kAvx2 &&
+      level_allowed("avx512")) {
+    // the 4x4 transpose and the 4x8 GEMM tile are kept from AVX2
+    table.level = SimdLevel::kAvx512;
+    table.add = add_avx512;
+    table.sub = sub_avx512;
+    table.add3 = add3_avx512;
+    table.sub3 = sub3_avx512;
+    table.scale = scale_avx512;
+    table.axpy = axpy_avx512;
+    table.rot = rot_avx512;
+    table.equal = equal_avx512;
+  }
+  return table;
+}
+
+const KernelTable &kernels() noexcept {
+  static const KernelTable table = select_kernels();
+  return table;
+}
+
+}  // namespace
+
+SimdLevel simd_level() noexcept { return kernels().level; }
+
+const char *simd_level_name() noexcept {
+  switch (simd_level()) {
+    case SimdLevel::kAvx512:
+      return "avx512";
+    case SimdLevel::kAvx2:
+      return "avx2";
+    default:
+      return "scalar";
+  }
+}
+
+void vec_add(double *a, const double *b, long n) noexcept {
+  kernels().add(a, b, n);
+}
+
+void vec_sub(double *a, const double *b, long n) noexcept {
+  kernels().sub(a, b, n);
+}
+
+void vec_add(double *c, const double *a, const double *b, long n) noexcept {
+  kernels().add3(c, a, b, n);
+}
+
+void vec_sub(double *c, const double *a, const double *b, long n) noexcept {
+  kernels().sub3(c, a, b, n);
+}
+
+void vec_scale(double *a, double s, long n) noexcept {
+  kernels().scale(a, s, n);
+}
+
+void vec_axpy(double *y, double alpha, const double *x, long n) noexcept {
+  kernels().axpy(y, alpha, x, n);
+}
+
+void vec_rot(double *x, double *y, double c, double s, long n) noexcept {
+  kernels().rot(x, y, c, s, n);
+}
+
+bool vec_equal(const double *a, const double *b, long n,
+               double tolerance) noexcept {
+  return kernels().equal(a, b, n, tolerance);
+}
+
+void transpose(int rows, int cols, const double *a, long lda, double *b,
+               long ldb) noexcept {
+  transpose_recursive(rows, cols, a, lda, b, ldb, kernels().transpose);
+}
+
+void gemm_micro_kernel(int kc, double alpha, const double *a, const double *b,
+                       double *c, long ldc, int mr, int nr) noexcept {
+  kernels().micro_kernel(kc, alpha, a, b, c, ldc, mr, nr);
+}
+
+}  // namespace s21
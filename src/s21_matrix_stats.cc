@@ -0,0 +1,151 @@
+#include "s21_matrix_stats.h"
+
+#include <atomic>
+#include <cstdio>
+
+namespace {
+
+constexpr int kOps = static_cast<int>(S21StatsOp::kCount);
+
+struct Counters {
+  std::atomic<std::uint64_t> calls{0};
+  std::atomic<std::uint64_t> flops{0};
+  std::atomic<std::uint64_t> bytes{0};
+  std::atomic<std::uint64_t> nanoseconds{0};
+};
+
+Counters counters[kOps];
+
+// Innermost operation running on this thread
+thread_local S21StatsOp current_op = S21StatsOp::kOther;
+
+// Indexed by S21StatsOp, with a fallback for invalid values last
+const char *const kNames[kOps + 1] = {
+    "construct", "copy", "move", "sum_matrix", "mul_number",
+    "mul_matrix", "transpose", "determinant", "calc_complements", "minor",
+    "inverse_matrix", "solve", "lu", "cholesky", "qr", "other", "unknown"};
+
+Counters &at(S21StatsOp op) noexcept { return counters[static_cast<int>(op)]; }
+
+}  // namespace
+
+// Stats
+
+S21StatsSnapshot S21Stats::Snapshot() noexcept {
+  S21StatsSnapshot sol;
+  for (int k = 0; k < kOps; k++) {
+    const auto op = static_cast<S21StatsOp>(k);
+    sol[op].calls = counters[k].calls.load(std::memory_order_relaxed);
+    sol[op].flops = counters[k].flops.load(std::memory_order_relaxed);
+    sol[op].bytes = counters[k].bytes.load(std::memory_order_relaxed);
+    sol[op].nanoseconds =
+        counters[k].nanoseconds.load(std::memory_order_relaxed);
+  }
+  return sol;
+}
+
+void S21Stats::Reset() noexcept {
+  for (Counters &c : counters) {
+    c.calls = 0;
+    c.flops = 0;
+    c.bytes = 0;
+    c.nanoseconds = 0;
+  }
+}
+
+const char *S21Stats::Name(S21StatsOp op) noexcept {
+  const int k = static_cast<int>(op);
+  return kNames[k >= 0 && k < kOps ? k : kOps];
+}
+
+void S21Stats::AddBytes(std::uint64_t bytes) noexcept {
+  at(current_op).bytes.fetch_add(bytes, std::memory_order_relaxed);
+}
+
+void S21Stats::AddCall(S21StatsOp op) noexcept {
+  at(op).calls.fetch_add(1, std::memory_order_relaxed);
+}
+
+// Scope
+
+S21StatsScope::S21StatsScope(S21StatsOp op, std::uint64_t flops) noexcept
+    : op_(op), outer_(current_op), active_(op != current_op) {
+  if (!active_) return;
+  at(op_).calls.fetch_add(1, std::memory_order_relaxed);
+  at(op_).flops.fetch_add(flops, std::memory_order_relaxed);
+  current_op = op_;
+  start_ = std::chrono::steady_clock::now();
+}
+
+S21StatsScope::~S21StatsScope() {
+  if (!active_) return;
+  const auto elapsed = std::chrono::steady_clock::now() - start_;
+  at(op_).nanoseconds.fetch_add(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count(),
+      std::memory_order_relaxed);
+  current_op = outer_;
+}
+
+// Snapshot
+
+S21StatsSnapshot S21StatsSnapshot::operator-(
+    const S21StatsSnapshot &before) const noexcept {
+  S21StatsSnapshot sol;
+  for (int k = 0; k < kOps; k++) {
+    sol.ops_[k].calls = ops_[k].calls - before.ops_[k].calls;
+    sol.ops_[k].flops = ops_[k].flops - before.ops_[k].flops;
+    sol.ops_[k].bytes = ops_[k].bytes - before.ops_[k].bytes;
+    sol.ops_[k].nanoseconds = ops_[k].nanoseconds - before.ops_[k].nanoseconds;
+  }
+  return sol;
+}
+
+std::string S21StatsSnapshot::ToJson() const {
+  std::string sol = "{";
+  char line[256];
+  for (int k = 0; k < kOps; k++) {
+    const S21OpStats &s = ops_[k];
+    std::snprintf(line, sizeof(line),
+                  "%s\"%s\": {\"calls\": %llu, \"flops\": %llu, "
+                  "\"bytes\": %llu, \"seconds\": %.9g}",
+                  k ? ", " : "", kNames[k],
+                  static_cast<unsigned long long>(s.calls),
+                  static_cast<unsigned long long>(s.flops),
+                  static_cast<unsigned long long>(s.bytes),
+                  s.nanoseconds * 1e-9);
+    sol += line;
+  }
+  return sol + "}";
+}
+
+std::string S21StatsSnapshot::ToPrometheus() const {
+  struct Family {
+    const char *name, *help;
+  };
+  const Family families[] = {
+      {"s21_matrix_calls_total", "Calls of matrix operations."},
+      {"s21_matrix_flops_total", "Floating point operations."},
+      {"s21_matrix_allocated_bytes_total", "Bytes of matrix buffers."},
+      {"s21_matrix_seconds_total", "Wall time of matrix operations."}};
+  std::string sol;
+  char line[256];
+  for (int f = 0; f < 4; f++) {
+    sol += std::string("# HELP ") + families[f].name + " " +
+           families[f].help + "\n# TYPE " + families[f].name + " counter\n";
+    for (int k = 0; k < kOps; k++) {
+      const S21OpStats &s = ops_[k];
+      if (f == 3) {
+        std::snprintf(line, sizeof(line), "%s{op=\"%s\"} %.9g\n",
+                      families[f].name, kNames[k], s.nanoseconds * 1e-9);
+      } else {
+        const std::uint64_t value =
+            f == 0 ? s.calls : f == 1 ? s.flops : s.bytes;
+        std::snprintf(line, sizeof(line), "%s{op=\"%s\"} %llu\n",
+                      families[f].name, kNames[k],
+                      static_cast<unsigned long long>(value));
+      }
+      sol += line;
+    }
+  }
+  return sol;
+}
@@ -0,0 +1,116 @@
+#ifndef MATRIX_SRC_S21_MATRIX_STATS_H
+#define MATRIX_SRC_S21_MATRIX_STATS_H
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+// Optional per-operation counters: calls, floating point operations, bytes
+// of matrix buffers allocated and wall time. They are compiled into the
+// library when it is built with -DS21_MATRIX_STATS (`make test_stats`);
+// otherwise the S21_STATS_* hooks expand to nothing and cost nothing.
+//
+// FLOPs are counted where the arithmetic runs (a multiply-add is 2, a
+// complex element operation counts like a real one), so InverseMatrix()
+// shows its time while the factorization and the solves show the work.
+// Time is inclusive of nested operations. Bytes go to the innermost timed
+// operation running on the allocating thread, or to kOther. Constructions
+// and moves are only counted. An operation that calls itself (Multiply on
+// aliased operands) counts once. Counters are atomic and global across
+// threads.
+enum class S21StatsOp {
+  kConstruct,        // S21BasicMatrix(rows, cols), calls only
+  kCopy,             // Copy construction and copy assignment
+  kMove,             // Move construction and move assignment, calls only
+  kSumMatrix,        // SumMatrix, SubMatrix and +=, -=
+  kMulNumber,
+  kMulMatrix,        // MulMatrix, Multiply(Strassen) and operator*
+  kTranspose,
+  kDeterminant,
+  kCalcComplements,
+  kMinor,            // Cofactor minors built by CalcComplements
+  kInverseMatrix,
+  kSolve,            // Solve on a matrix or a factorization
+  kLU,               // LU factorization
+  kCholesky,         // Cholesky factorization
+  kQR,               // QR factorization
+  kOther,            // Allocations outside any counted operation
+  kCount
+};
+
+struct S21OpStats {
+  std::uint64_t calls = 0;
+  std::uint64_t flops = 0;
+  std::uint64_t bytes = 0;
+  std::uint64_t nanoseconds = 0;
+};
+
+// Copy of every counter at one moment
+class S21StatsSnapshot {
+ private:
+  std::array<S21OpStats, static_cast<int>(S21StatsOp::kCount)> ops_{};
+
+ public:
+  [[nodiscard]] S21OpStats &operator[](S21StatsOp op) noexcept {
+    return ops_[static_cast<int>(op)];
+  }
+  [[nodiscard]] const S21OpStats &operator[](S21StatsOp op) const noexcept {
+    return ops_[static_cast<int>(op)];
+  }
+  // Counts between `before` and this snapshot
+  [[nodiscard]] S21StatsSnapshot operator-(
+      const S21StatsSnapshot &before) const noexcept;
+  // {"mul_matrix": {"calls": 1, "flops": 2, "bytes": 64,
+  // "seconds": 1e-06}, ...}
+  [[nodiscard]] std::string ToJson() const;
+  // Prometheus text exposition format, one counter family per field with
+  // an op label
+  [[nodiscard]] std::string ToPrometheus() const;
+};
+
+class S21Stats {
+ public:
+#ifdef S21_MATRIX_STATS
+  static constexpr bool kEnabled = true;
+#else
+  static constexpr bool kEnabled = false;
+#endif
+
+  [[nodiscard]] static S21StatsSnapshot Snapshot() noexcept;
+  static void Reset() noexcept;
+  // snake_case name used in the dumps
+  [[nodiscard]] static const char *Name(S21StatsOp op) noexcept;
+  // Adds bytes to the operation running on this thread
+  static void AddBytes(std::uint64_t bytes) noexcept;
+  // Counts a call without timing it
+  static void AddCall(S21StatsOp op) noexcept;
+};
+
+// Counts one call of `op` and its duration for the lifetime of the scope
+class S21StatsScope {
+ private:
+  S21StatsOp op_;
+  S21StatsOp outer_;  // Operation this one runs inside of
+  bool active_;       // False when nested inside the same operation
+  std::chrono::steady_clock::time_point start_;
+
+ public:
+  explicit S21StatsScope(S21StatsOp op, std::uint64_t flops = 0) noexcept;
+  S21StatsScope(const S21StatsScope &) = delete;
+  S21StatsScope &operator=(const S21StatsScope &) = delete;
+  ~S21StatsScope();
+};
+
+#ifdef S21_MATRIX_STATS
+#define S21_STATS_SCOPE(op, flops) \
+  S21StatsScope s21_stats_scope(S21StatsOp::op, (flops))
+#define S21_STATS_COUNT(op) S21Stats::AddCall(S21StatsOp::op)
+#define S21_STATS_BYTES(bytes) S21Stats::AddBytes(bytes)
+#else
+#define S21_STATS_SCOPE(op, flops) static_cast<void>(0)
+#define S21_STATS_COUNT(op) static_cast<void>(0)
+#define S21_STATS_BYTES(bytes) static_cast<void>(0)
+#endif
+
+#endif  // MATRIX_SRC_S21_MATRIX_STATS_H
@@ -1,9 +1,25 @@
 #include <gtest/gtest.h>
 
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
 #include <cstdlib>
 #include <iostream>
-
+#include <vector>
+
+#include "s21_batch_matrix.h"
+#include "s21_fixed_matrix.h"
+#include "s21_matrix_eigen.h"
+#include "s21_matrix_io.h"
+#include "s21_matrix_kernels.h"
+#include "s21_matrix_memory.h"
+#include "s21_matrix_text.h"
 #include "s21_matrix_oop.h"
+#include "s21_matrix_stats.h"
+#include "s21_matrix_view.h"
+#include "s21_sparse_matrix.h"
+#include "s21_thread_pool.h"
+#include "s21_tiled_matrix.h"
 
 void randm(S21Matrix &m) {
   for (int i = 0; i < m.getRows(); i++)
@@ -631,8 +647,1336 @@ TEST(valgr, gg) {
   func_inverse = given.InverseMatrix();
 }
 
+TEST(storage, contiguous) {
+  S21Matrix m(3, 4);
+  for (int i = 0; i < 3; i++)
+    for (int j = 0; j < 4; j++) m(i, j) = i * 4 + j;
+  EXPECT_EQ(m.stride(), 4);
+  EXPECT_EQ(reinterpret_cast<std::uintptr_t>(m.data()) % S21Matrix::kAlignment,
+            0u);
+  for (int k = 0; k < 12; k++) EXPECT_DOUBLE_EQ(m.data()[k], k);
+}
+
+TEST(storage, resize_keeps_data) {
+  S21Matrix m(2, 3);
+  randm(m);
+  S21Matrix copy(m);
+  m.setCols(5);
+  m.setRows(4);
+  EXPECT_EQ(m.stride(), 5);
+  for (int i = 0; i < 4; i++)
+    for (int j = 0; j < 5; j++)
+      EXPECT_DOUBLE_EQ(m(i, j), (i < 2 && j < 3) ? copy(i, j) : 0);
+}
+
+TEST(storage, copy_assign_same_shape) {
+  S21Matrix m1(3, 3), m2(3, 3);
+  randm(m1);
+  const double *buffer = m2.data();
+  m2 = m1;
+  EXPECT_EQ(m2.data(), buffer);
+  EXPECT_TRUE(m1 == m2);
+}
+
+TEST(storage, append_rows_amortized) {
+  S21Matrix m(1, 7);
+  int reallocations = 0;
+  const double *buffer = m.data();
+  for (int i = 1; i < 1000; i++) {
+    m.setRows(i + 1);
+    m(i, 6) = i;
+    if (m.data() != buffer) reallocations++;
+    buffer = m.data();
+  }
+  EXPECT_LT(reallocations, 20);
+  EXPECT_GE(m.row_capacity(), 1000);
+  for (int i = 1; i < 1000; i++) EXPECT_EQ(m(i, 6), i);
+  m.shrink_to_fit();
+  EXPECT_EQ(m.row_capacity(), 1000);
+  EXPECT_EQ(m(999, 6), 999);
+}
+
+TEST(storage, reserve_and_regrow) {
+  S21Matrix m(2, 2);
+  m.reserve(8, 6);
+  const double *buffer = m.data();
+  EXPECT_EQ(m.col_capacity(), 6);
+  m(1, 1) = 3;
+  m.setCols(5);
+  m.setRows(8);
+  EXPECT_EQ(m.data(), buffer);
+  m(7, 4) = 1;
+  m(0, 4) = 2;
+  // shrinking keeps capacity, regrowing exposes zeroes, not stale values
+  m.setRows(2);
+  m.setCols(2);
+  m.setCols(5);
+  m.setRows(8);
+  EXPECT_EQ(m.data(), buffer);
+  EXPECT_EQ(m(1, 1), 3);
+  EXPECT_EQ(m(7, 4), 0);
+  EXPECT_EQ(m(0, 4), 0);
+  S21Matrix copy(m);
+  EXPECT_EQ(copy.stride(), 5);
+  EXPECT_TRUE(copy == m);
+  m.shrink_to_fit();
+  EXPECT_EQ(m.stride(), 5);
+  EXPECT_TRUE(copy == m);
+  EXPECT_THROW(m.reserve(-1, 2), std::out_of_range);
+}
+
+TEST(storage, unchecked_access) {
+  // padded rows: stride 6, 4 columns in use
+  S21Matrix m(3, 6);
+  m.setCols(4);
+  for (int i = 0; i < 3; i++)
+    for (int j = 0; j < 4; j++) m.at_unchecked(i, j) = i * 4 + j;
+  const S21Matrix &c = m;
+  EXPECT_EQ(c.at_unchecked(2, 3), m(2, 3));
+  EXPECT_EQ(m.row(1).data(), m.data() + m.stride());
+  EXPECT_EQ(m.row(1).size(), 4);
+  EXPECT_EQ(c.row(2)[1], 9);
+  int k = 0;
+  for (double x : c) EXPECT_EQ(x, k++);
+  EXPECT_EQ(k, 12);
+  for (double &x : m) x *= 2;
+  EXPECT_EQ(m(2, 3), 22);
+  EXPECT_EQ(m.rows().size(), 3);
+  int i = 0;
+  for (auto row : c.rows()) {
+    EXPECT_EQ(row.size(), 4);
+    for (int j = 0; j < 4; j++) EXPECT_EQ(row[j], 2 * (i * 4 + j));
+    i++;
+  }
+  EXPECT_EQ(i, 3);
+  auto it = c.rows().begin() + 2;
+  EXPECT_EQ(it - c.rows().begin(), 2);
+  EXPECT_EQ((*it)[0], 16);
+  S21Matrix empty;
+  EXPECT_TRUE(empty.begin() == empty.end());
+  // operator() keeps its checks
+  EXPECT_THROW(m(3, 0), std::out_of_range);
+  EXPECT_THROW(m(0, 4), std::out_of_range);
+  EXPECT_THROW(m(-1, 0), std::out_of_range);
+  EXPECT_THROW(c(0, -1), std::out_of_range);
+}
+
+TEST(lu, determinant_large) {
+  int size = 60;
+  S21Matrix m(size, size);
+  for (int i = 0; i < size; i++) {
+    m(i, i) = 2;
+    if (i + 1 < size) m(i, i + 1) = 1;
+  }
+  // upper bidiagonal, det = 2^size
+  EXPECT_NEAR(m.Determinant() / std::pow(2.0, size), 1, 1e-12);
+}
+
+TEST(lu, singular) {
+  S21Matrix m(3, 3);
+  for (int i = 0; i < 3; i++)
+    for (int j = 0; j < 3; j++) m(i, j) = i + j;
+  S21LU lu = m.LU();
+  EXPECT_NEAR(lu.Determinant(), 0, 1e-9);
+  EXPECT_ANY_THROW(m.InverseMatrix());
+  // the threshold is relative, a small but well-conditioned matrix is fine
+  S21Matrix small(3, 3), big(3, 3);
+  for (int i = 0; i < 3; i++) {
+    small(i, i) = 1e-8;
+    big(i, i) = 1e8;
+  }
+  EXPECT_TRUE(small.LU().IsInvertible());
+  EXPECT_TRUE(small.InverseMatrix() * 1e-16 == big * 1e-16);
+  EXPECT_TRUE(small.CalcComplements() * 1e16 == small * 1e8);
+  // badly scaled: too ill-conditioned to solve, the determinant is exact
+  S21Matrix scaled(2, 2);
+  scaled(0, 0) = 1e8;
+  scaled(1, 1) = 1e-8;
+  EXPECT_FALSE(scaled.LU().IsInvertible());
+  EXPECT_DOUBLE_EQ(scaled.Determinant(), 1);
+  scaled(0, 1) = 3;
+  scaled(1, 0) = 2e-8;
+  EXPECT_NEAR(scaled.Determinant(), 1 - 6e-8, 1e-15);
+}
+
+TEST(lu, solve) {
+  S21Matrix a(3, 3), b(3, 2);
+  a(0, 0) = 0;
+  a(0, 1) = 2;
+  a(0, 2) = 1;
+  a(1, 0) = 1;
+  a(1, 1) = 1;
+  a(1, 2) = 1;
+  a(2, 0) = 4;
+  a(2, 1) = -1;
+  a(2, 2) = 3;
+  randm(b);
+  S21Matrix x = a.Solve(b);
+  EXPECT_TRUE(a * x == b);
+  EXPECT_ANY_THROW(a.Solve(S21Matrix(2, 1)));
+}
+
+TEST(lu, inverse_large) {
+  int size = 100;
+  S21Matrix m(size, size);
+  randm(m);
+  for (int i = 0; i < size; i++) m(i, i) += 10 * size;
+  S21Matrix identity(size, size);
+  for (int i = 0; i < size; i++) identity(i, i) = 1;
+  EXPECT_TRUE(m * m.InverseMatrix() == identity);
+}
+
+TEST(lu, complements) {
+  // A * C^T = det(A) * I, from the inverse and from the minors
+  const int n = 30;
+  S21Matrix a(n, n), identity(n, n);
+  randm(a);
+  for (int i = 0; i < n; i++) {
+    a(i, i) += n;
+    identity(i, i) = 1;
+  }
+  const double det = a.Determinant();
+  const S21Matrix c = a.CalcComplements();
+  EXPECT_TRUE(a * c.Transpose() * (1 / det) == identity);
+  // rank n - 1: A * C^T = 0, C itself is not
+  S21Matrix s(6, 6);
+  randm(s);
+  for (int j = 0; j < 6; j++) s(5, j) = s(0, j) + 2 * s(1, j);
+  const S21Matrix sc = s.CalcComplements();
+  EXPECT_FALSE(sc == S21Matrix(6, 6));
+  EXPECT_TRUE(s * sc.Transpose() == S21Matrix(6, 6));
+  S21ThreadPool::SetThreadCount(4);
+  S21ThreadPool::SetSerialThreshold(0);
+  EXPECT_TRUE(s.CalcComplements() == sc);
+  S21ThreadPool::SetSerialThreshold(1L << 18);
+  S21ThreadPool::SetThreadCount(1);
+}
+
+TEST(cholesky, solve) {
+  const int n = 40;
+  S21Matrix g(n, n), b(n, 3);
+  randm(g);
+  randm(b);
+  // G^T * G + n * I is symmetric positive definite
+  S21Matrix a;
+  S21Matrix::Multiply(a, g, g, 1.0, 0.0, S21Transpose::kYes);
+  for (int i = 0; i < n; i++) a(i, i) += n;
+  const S21Cholesky chol = a.Cholesky();
+  ASSERT_TRUE(chol.IsPositiveDefinite());
+  EXPECT_NEAR(chol.Determinant() / a.Determinant(), 1, 1e-9);
+  // the factorization is reused for every right-hand side
+  EXPECT_TRUE(a * chol.Solve(b) == b);
+  EXPECT_TRUE(chol.Solve(b) == a.LU().Solve(b));
+  EXPECT_TRUE(chol.InverseMatrix() == a.InverseMatrix());
+  // only the upper triangle is read
+  S21Matrix upper = a;
+  for (int i = 1; i < n; i++)
+    for (int j = 0; j < i; j++) upper(i, j) = 0;
+  EXPECT_TRUE(S21Cholesky(upper).Solve(b) == chol.Solve(b));
+  S21Matrix indefinite(2, 2);
+  indefinite(0, 0) = 1;
+  indefinite(0, 1) = indefinite(1, 0) = 2;
+  indefinite(1, 1) = 1;
+  const S21Cholesky bad = indefinite.Cholesky();
+  EXPECT_FALSE(bad.IsPositiveDefinite());
+  EXPECT_EQ(bad.Determinant(), 0);
+  EXPECT_THROW((void)bad.Solve(S21Matrix(2, 1)), std::out_of_range);
+  EXPECT_THROW((void)chol.Solve(S21Matrix(3, 1)), std::out_of_range);
+  EXPECT_THROW((void)S21Matrix(2, 3).Cholesky(), std::out_of_range);
+  // Hermitian
+  using C = std::complex<double>;
+  S21BasicMatrix<C> h(2, 2), hb(2, 1);
+  h(0, 0) = 4;
+  h(0, 1) = C(1, 2);
+  h(1, 0) = C(1, -2);
+  h(1, 1) = 6;
+  hb(0, 0) = C(1, 1);
+  hb(1, 0) = C(0, -3);
+  const S21BasicCholesky<C> hc(h);
+  ASSERT_TRUE(hc.IsPositiveDefinite());
+  EXPECT_TRUE(h * hc.Solve(hb) == hb);
+  EXPECT_NEAR(std::abs(hc.Determinant() - C(19, 0)), 0, 1e-12);
+}
+
+TEST(qr, factors_and_least_squares) {
+  S21Matrix a(30, 7), b(30, 2);
+  randm(a);
+  randm(b);
+  const S21QR qr = a.QR();
+  ASSERT_FALSE(qr.IsRankDeficient());
+  const S21Matrix q = qr.Q(), r = qr.R();
+  EXPECT_TRUE(q * r == a);
+  S21Matrix identity(7, 7);
+  for (int i = 0; i < 7; i++) identity(i, i) = 1;
+  S21Matrix qtq;
+  S21Matrix::Multiply(qtq, q, q, 1.0, 0.0, S21Transpose::kYes);
+  EXPECT_TRUE(qtq == identity);
+  for (int i = 1; i < 7; i++) EXPECT_EQ(r(i, 0), 0);
+  // least squares: the residual is orthogonal to the columns of A
+  const S21Matrix x = a.Solve(b);
+  ASSERT_EQ(x.getRows(), 7);
+  S21Matrix normal;
+  S21Matrix::Multiply(normal, a, a * x - b, 1.0, 0.0, S21Transpose::kYes);
+  EXPECT_TRUE(normal == S21Matrix(7, 2));
+  EXPECT_TRUE(x == qr.Solve(b));
+  // square systems are solved exactly
+  S21Matrix s(12, 12), sb(12, 4);
+  randm(s);
+  randm(sb);
+  EXPECT_TRUE(s * s.QR().Solve(sb) == sb);
+  S21Matrix deficient(4, 2);
+  for (int i = 0; i < 4; i++) deficient(i, 0) = deficient(i, 1) = i + 1;
+  EXPECT_TRUE(deficient.QR().IsRankDeficient());
+  EXPECT_THROW((void)deficient.Solve(S21Matrix(4, 1)), std::out_of_range);
+  EXPECT_THROW((void)qr.Solve(S21Matrix(7, 1)), std::out_of_range);
+  EXPECT_THROW((void)S21Matrix(2, 3).QR(), std::out_of_range);
+  using C = std::complex<double>;
+  S21BasicMatrix<C> c(5, 3), cb(5, 1);
+  for (int i = 0; i < 5; i++) {
+    for (int j = 0; j < 3; j++) c(i, j) = C(std::sin(3 * i + j), i * j);
+    cb(i, 0) = C(i, 1);
+  }
+  const S21BasicQR<C> cqr(c);
+  EXPECT_TRUE(cqr.Q() * cqr.R() == c);
+  // A^H * (A * x - b) = 0
+  const S21BasicMatrix<C> residual = c * cqr.Solve(cb) - cb;
+  for (int j = 0; j < 3; j++) {
+    C dot = 0;
+    for (int i = 0; i < 5; i++) dot += std::conj(c(i, j)) * residual(i, 0);
+    EXPECT_NEAR(std::abs(dot), 0, 1e-10);
+  }
+}
+
+TEST(eigen, symmetric) {
+  const int n = 60;
+  S21Matrix a(n, n), identity(n, n);
+  for (int i = 0; i < n; i++) {
+    identity(i, i) = 1;
+    for (int j = i; j < n; j++) a(i, j) = a(j, i) = rand() % 21 - 10;
+  }
+  const S21SymmetricEigen eig(a);
+  const S21Matrix &w = eig.Eigenvalues(), &v = eig.Eigenvectors();
+  ASSERT_EQ(w.getRows(), n);
+  for (int i = 1; i < n; i++) EXPECT_LE(w(i - 1, 0), w(i, 0));
+  S21Matrix vtv;
+  S21Matrix::Multiply(vtv, v, v, 1.0, 0.0, S21Transpose::kYes);
+  EXPECT_TRUE(vtv == identity);
+  // A * V = V * diag(w)
+  S21Matrix av = a * v;
+  for (int j = 0; j < n; j++)
+    for (int i = 0; i < n; i++) ASSERT_NEAR(av(i, j), v(i, j) * w(j, 0), 1e-9);
+  // values only, in parallel, reading the upper triangle
+  S21Matrix upper = a;
+  for (int i = 1; i < n; i++)
+    for (int j = 0; j < i; j++) upper(i, j) = 0;
+  S21ThreadPool::SetThreadCount(4);
+  S21ThreadPool::SetSerialThreshold(0);
+  const S21SymmetricEigen values(upper, false);
+  S21ThreadPool::SetSerialThreshold(1L << 18);
+  S21ThreadPool::SetThreadCount(1);
+  EXPECT_TRUE(values.Eigenvalues() == w);
+  EXPECT_EQ(values.Eigenvectors().getRows(), 0);
+  // 2 - sqrt(2), 2, 2 + sqrt(2)
+  S21BasicMatrix<float> t(3, 3);
+  t(0, 0) = t(1, 1) = t(2, 2) = 2;
+  t(0, 1) = t(1, 2) = 1;
+  const S21BasicSymmetricEigen<float> te(t);
+  EXPECT_NEAR(te.Eigenvalues()(0, 0), 2 - std::sqrt(2.0f), 1e-5f);
+  EXPECT_NEAR(te.Eigenvalues()(2, 0), 2 + std::sqrt(2.0f), 1e-5f);
+  EXPECT_THROW(S21SymmetricEigen(S21Matrix(2, 3)), std::out_of_range);
+}
+
+TEST(eigen, svd) {
+  for (auto [m, n] : {std::pair{25, 9}, {9, 25}, {60, 12}, {16, 16}, {7, 1}}) {
+    S21Matrix a(m, n);
+    randm(a);
+    const S21SVD svd(a);
+    const int k = std::min(m, n);
+    const S21Matrix &u = svd.U(), &s = svd.SingularValues(), &v = svd.V();
+    ASSERT_EQ(u.getRows(), m);
+    ASSERT_EQ(u.getCols(), k);
+    ASSERT_EQ(v.getRows(), n);
+    ASSERT_EQ(v.getCols(), k);
+    S21Matrix us = u, identity(k, k);
+    for (int j = 0; j < k; j++) {
+      identity(j, j) = 1;
+      EXPECT_GE(s(j, 0), 0);
+      if (j) {
+        EXPECT_LE(s(j, 0), s(j - 1, 0));
+      }
+      for (int i = 0; i < m; i++) us(i, j) *= s(j, 0);
+    }
+    S21Matrix product;
+    S21Matrix::Multiply(product, us, v, 1.0, 0.0, S21Transpose::kNo,
+                        S21Transpose::kYes);
+    EXPECT_TRUE(product == a);
+    S21Matrix utu, vtv;
+    S21Matrix::Multiply(utu, u, u, 1.0, 0.0, S21Transpose::kYes);
+    S21Matrix::Multiply(vtv, v, v, 1.0, 0.0, S21Transpose::kYes);
+    EXPECT_TRUE(utu == identity);
+    EXPECT_TRUE(vtv == identity);
+    EXPECT_TRUE(S21SVD(a, false).SingularValues() == s);
+    EXPECT_EQ(svd.Rank(), k);
+  }
+  // rank one, columns proportional
+  S21Matrix r(6, 4);
+  for (int i = 0; i < 6; i++)
+    for (int j = 0; j < 4; j++) r(i, j) = (i + 1.0) * (j + 1);
+  const S21SVD rs(r);
+  EXPECT_EQ(rs.Rank(), 1);
+  EXPECT_GT(rs.ConditionNumber(), 1e12);
+  S21Matrix d(3, 3);
+  d(0, 0) = -4;
+  d(1, 1) = 2;
+  d(2, 2) = 0.5;
+  EXPECT_NEAR(S21SVD(d).ConditionNumber(), 8, 1e-12);
+  EXPECT_NEAR(S21SVD(d).SingularValues()(0, 0), 4, 1e-12);
+}
+
+TEST(gemm, matches_reference) {
+  const int sizes[][3] = {{1, 1, 1}, {5, 7, 3}, {33, 17, 65}, {97, 130, 301}};
+  for (auto &size : sizes) {
+    S21Matrix a(size[0], size[2]), b(size[2], size[1]);
+    randm(a);
+    randm(b);
+    S21Matrix expected(size[0], size[1]);
+    for (int i = 0; i < size[0]; i++)
+      for (int j = 0; j < size[1]; j++)
+        for (int k = 0; k < size[2]; k++) expected(i, j) += a(i, k) * b(k, j);
+    EXPECT_TRUE(a * b == expected);
+  }
+}
+
+TEST(simd, element_wise_tails) {
+  std::cout << "simd level: " << s21::simd_level_name() << std::endl;
+  for (int cols = 1; cols <= 19; cols += 3) {
+    S21Matrix a(3, cols), b(3, cols);
+    randm(a);
+    randm(b);
+    S21Matrix sum = a + b, diff = a - b, scaled = a * 0.5;
+    for (int i = 0; i < 3; i++) {
+      for (int j = 0; j < cols; j++) {
+        EXPECT_DOUBLE_EQ(sum(i, j), a(i, j) + b(i, j));
+        EXPECT_DOUBLE_EQ(diff(i, j), a(i, j) - b(i, j));
+        EXPECT_DOUBLE_EQ(scaled(i, j), a(i, j) * 0.5);
+      }
+    }
+    S21Matrix c(a);
+    EXPECT_TRUE(a == c);
+    c(2, cols - 1) += 1e-6;
+    EXPECT_FALSE(a == c);
+    // three operand forms, writing over an operand
+    s21::vec_add(c.data(), a.data(), b.data(), 3L * cols);
+    EXPECT_TRUE(c == sum);
+    s21::vec_sub(c.data(), a.data(), c.data(), 3L * cols);
+    EXPECT_TRUE(c == b * -1.0);
+    c = a;
+    s21::vec_axpy(c.data(), 2.0, b.data(), 3L * cols);
+    EXPECT_TRUE(c == a + b * 2.0);
+    // rotation by 90 degrees: (a, b) -> (b, -a)
+    S21Matrix x(a), y(b);
+    s21::vec_rot(x.data(), y.data(), 0.0, 1.0, 3L * cols);
+    EXPECT_TRUE(x == b);
+    EXPECT_TRUE(y == a * -1.0);
+  }
+}
+
+TEST(simd, transpose_blocks) {
+  S21Matrix m(13, 7);
+  randm(m);
+  S21Matrix t = m.Transpose();
+  for (int i = 0; i < 13; i++)
+    for (int j = 0; j < 7; j++) EXPECT_DOUBLE_EQ(m(i, j), t(j, i));
+  // recursive splits, thin shapes and ragged leaves
+  for (auto [rows, cols] : {std::pair{100, 37}, {3, 200}, {150, 2}, {65, 65}}) {
+    S21Matrix a(rows, cols);
+    randm(a);
+    const S21Matrix at = a.Transpose();
+    ASSERT_EQ(at.getRows(), cols);
+    for (int i = 0; i < rows; i++)
+      for (int j = 0; j < cols; j++) ASSERT_EQ(a(i, j), at(j, i));
+  }
+}
+
+TEST(simd, transpose_in_place) {
+  for (int n : {1, 5, 32, 70}) {
+    S21Matrix a(n, n);
+    randm(a);
+    const S21Matrix expected = a.Transpose();
+    a.TransposeInPlace();
+    EXPECT_TRUE(a == expected);
+  }
+  // padded rows stay padded
+  S21Matrix p(40, 48);
+  p.setCols(40);
+  randm(p);
+  const S21Matrix expected = p.Transpose();
+  p.TransposeInPlace();
+  EXPECT_EQ(p.stride(), 48);
+  EXPECT_TRUE(p == expected);
+  // other shapes go through a new buffer
+  S21Matrix r(37, 20);
+  randm(r);
+  const S21Matrix rt = r.Transpose();
+  r.TransposeInPlace();
+  EXPECT_EQ(r.getRows(), 20);
+  EXPECT_TRUE(r == rt);
+  S21ThreadPool::SetThreadCount(4);
+  S21ThreadPool::SetSerialThreshold(0);
+  S21Matrix big(130, 130);
+  randm(big);
+  const S21Matrix bt = big.Transpose();
+  big.TransposeInPlace();
+  EXPECT_TRUE(big == bt);
+  S21ThreadPool::SetSerialThreshold(1L << 18);
+  S21ThreadPool::SetThreadCount(1);
+}
+
+TEST(thread_pool, parallel_matches_serial) {
+  S21Matrix a(150, 130), b(130, 170), c(150, 130);
+  randm(a);
+  randm(b);
+  randm(c);
+  S21Matrix square(120, 120);
+  randm(square);
+  for (int i = 0; i < 120; i++) square(i, i) += 20;
+
+  S21Matrix product = a * b, sum = a + c, transposed = a.Transpose();
+  S21Matrix inverse = square.InverseMatrix();
+  double det = square.Determinant();
+
+  S21ThreadPool::SetThreadCount(4);
+  S21ThreadPool::SetSerialThreshold(0);
+  EXPECT_EQ(S21ThreadPool::getThreadCount(), 4);
+  EXPECT_TRUE(a * b == product);
+  EXPECT_TRUE(a + c == sum);
+  EXPECT_TRUE(a.Transpose() == transposed);
+  EXPECT_TRUE(square.InverseMatrix() == inverse);
+  EXPECT_NEAR(square.Determinant() / det, 1, 1e-12);
+  EXPECT_FALSE(a == c);
+  S21Matrix small(4, 4);
+  randm(small);
+  EXPECT_TRUE(small.CalcComplements() ==
+              small.InverseMatrix().Transpose() * small.Determinant());
+  EXPECT_ANY_THROW(S21ThreadPool::SetThreadCount(-1));
+
+  S21ThreadPool::SetSerialThreshold(1L << 18);
+  S21ThreadPool::SetThreadCount(1);
+}
+
+TEST(expr, fused_assignment) {
+  S21Matrix a(3, 4), b(3, 4), c(3, 4), result(3, 4);
+  randm(a);
+  randm(b);
+  randm(c);
+  const double *buffer = result.data();
+  result = a + b * 2.0 - c;
+  EXPECT_EQ(result.data(), buffer);
+  for (int i = 0; i < 3; i++)
+    for (int j = 0; j < 4; j++)
+      EXPECT_DOUBLE_EQ(result(i, j), a(i, j) + b(i, j) * 2.0 - c(i, j));
+
+  // the target may appear in its own expression
+  S21Matrix expected = 0.5 * (result - a) + result;
+  result = 0.5 * (result - a) + result;
+  EXPECT_TRUE(result == expected);
+  result += a * 3;
+  result -= b - c;
+  expected = expected + a * 3 - (b - c);
+  EXPECT_TRUE(result == expected);
+}
+
+TEST(expr, shapes) {
+  S21Matrix a(2, 3), b(3, 2), empty;
+  EXPECT_THROW((void)(a + b), std::out_of_range);
+  EXPECT_THROW((void)(a - b * 2), std::out_of_range);
+  S21Matrix sum = empty + empty;
+  EXPECT_EQ(sum.getRows(), 0);
+  S21Matrix resized(5, 5);
+  resized = a * 2;
+  EXPECT_EQ(resized.getRows(), 2);
+  EXPECT_EQ(resized.getCols(), 3);
+  S21Matrix product = (a + a) * (b - b * 2);
+  EXPECT_TRUE(product == a * b * -2.0);
+}
+
+TEST(fixed, constexpr_arithmetic) {
+  constexpr S21Matrix2d a{1, 2, 3, 4};
+  constexpr S21Matrix2d b = a * a + 2.0 * S21Matrix2d::Identity();
+  static_assert(a.Determinant() == -2, "closed form 2x2 determinant");
+  static_assert(b(0, 0) == 9 && b(0, 1) == 10 && b(1, 1) == 24, "product");
+  static_assert(a.Transpose()(0, 1) == 3, "transpose");
+  constexpr S21Matrix2d inverse = a.InverseMatrix();
+  static_assert(inverse(0, 0) == -2 && inverse(1, 0) == 1.5, "inverse");
+  EXPECT_TRUE(a * inverse == S21Matrix2d::Identity());
+}
+
+template <int N>
+void check_fixed_against_dynamic() {
+  S21Matrix dynamic(N, N);
+  randm(dynamic);
+  for (int i = 0; i < N; i++) dynamic(i, i) += 10;
+  S21FixedMatrix<double, N, N> fixed(dynamic);
+  EXPECT_NEAR(fixed.Determinant(), dynamic.Determinant(),
+              1e-9 * std::abs(dynamic.Determinant()));
+  EXPECT_TRUE(fixed.InverseMatrix().ToMatrix() == dynamic.InverseMatrix());
+  EXPECT_TRUE(fixed.CalcComplements().ToMatrix() ==
+              dynamic.CalcComplements());
+  EXPECT_TRUE((fixed * fixed).ToMatrix() == dynamic * dynamic);
+}
+
+TEST(fixed, matches_dynamic) {
+  check_fixed_against_dynamic<1>();
+  check_fixed_against_dynamic<2>();
+  check_fixed_against_dynamic<3>();
+  check_fixed_against_dynamic<4>();
+  check_fixed_against_dynamic<6>();
+  EXPECT_THROW(S21Matrix3d(S21Matrix(2, 3)), std::out_of_range);
+  EXPECT_THROW((void)S21Matrix4d().InverseMatrix(), std::out_of_range);
+  using Matrix5d = S21FixedMatrix<double, 5, 5>;
+  EXPECT_THROW((void)Matrix5d().InverseMatrix(), std::out_of_range);
+}
+
+TEST(fixed, element_types) {
+  // float compares with its own, looser tolerance
+  using Matrix2f = S21FixedMatrix<float, 2, 2>;
+  const Matrix2f f{1, 2, 3, 4};
+  EXPECT_TRUE(f * f.InverseMatrix() == Matrix2f::Identity());
+  EXPECT_TRUE(f + Matrix2f{5e-6f} == f);
+  using C = std::complex<double>;
+  S21BasicMatrix<C> dynamic(5, 5);
+  for (int i = 0; i < 5; i++)
+    for (int j = 0; j < 5; j++)
+      dynamic(i, j) = C(std::sin(3 * i + j), i == j ? 10 : i - j);
+  const S21FixedMatrix<C, 5, 5> fixed(dynamic);
+  EXPECT_LT(std::abs(fixed.Determinant() - dynamic.Determinant()),
+            1e-9 * std::abs(dynamic.Determinant()));
+  EXPECT_TRUE(fixed.InverseMatrix().ToMatrix() == dynamic.InverseMatrix());
+  using Matrix3c = S21FixedMatrix<C, 3, 3>;
+  EXPECT_THROW((void)Matrix3c().InverseMatrix(), std::out_of_range);
+
+}
+
+template <int N>
+void check_fixed_scaled_identity(double scale) {
+  using Matrix = S21FixedMatrix<double, N, N>;
+  const Matrix a = Matrix::Identity() * scale;
+  EXPECT_TRUE(a.InverseMatrix() * scale == Matrix::Identity());
+}
+
+TEST(fixed, inverse_of_small_scale) {
+  // closed forms up to 4x4 and elimination above judge singularity
+  // relative to the elements, like S21Matrix
+  check_fixed_scaled_identity<2>(1e-4);
+  check_fixed_scaled_identity<3>(1e-3);
+  check_fixed_scaled_identity<4>(1e-2);
+  check_fixed_scaled_identity<5>(1e-8);
+  constexpr double scale = 1.0 / (1 << 30);
+  constexpr S21Matrix2d small{scale, 0, 0, scale};
+  static_assert(small.InverseMatrix()(1, 1) == 1 << 30, "constexpr inverse");
+  EXPECT_THROW((void)(S21Matrix4d{1e-3, 2e-3, 2e-3, 4e-3}.InverseMatrix()),
+               std::out_of_range);
+}
+
+template <typename T>
+void check_element_type() {
+  using Matrix = S21BasicMatrix<T>;
+  Matrix a(3, 3), b(3, 3);
+  for (int i = 0; i < 3; i++)
+    for (int j = 0; j < 3; j++) {
+      a(i, j) = T(rand() % 10);
+      b(i, j) = T(rand() % 10);
+    }
+  for (int i = 0; i < 3; i++) a(i, i) += T(20);
+  Matrix sum = a + b * T(2) - b;
+  EXPECT_TRUE(sum == a + b);
+  Matrix identity(3, 3);
+  for (int i = 0; i < 3; i++) identity(i, i) = T(1);
+  EXPECT_TRUE(a * a.InverseMatrix() == identity);
+  EXPECT_TRUE(a.CalcComplements().Transpose() * (T(1) / a.Determinant()) ==
+              a.InverseMatrix());
+  EXPECT_TRUE((a * b).Transpose() == b.Transpose() * a.Transpose());
+}
+
+TEST(element_type, all) {
+  check_element_type<float>();
+  check_element_type<double>();
+  check_element_type<long double>();
+  check_element_type<std::complex<double>>();
+}
+
+TEST(element_type, complex) {
+  using C = std::complex<double>;
+  S21MatrixCD m(2, 2);
+  m(0, 0) = C(0, 1);
+  m(0, 1) = C(2, 0);
+  m(1, 0) = C(1, 0);
+  m(1, 1) = C(0, -1);
+  // i * -i - 2 * 1 = 1 - 2
+  EXPECT_NEAR(std::abs(m.Determinant() - C(-1, 0)), 0, 1e-12);
+  S21MatrixCD inverse = m.InverseMatrix();
+  EXPECT_NEAR(std::abs(inverse(0, 0) - C(0, 1)), 0, 1e-12);
+  EXPECT_FALSE(m == m * C(0, 1));
+}
+
+TEST(memory, arena_scope) {
+  S21ArenaResource arena;
+  S21Matrix outside(3, 3);
+  randm(outside);
+  {
+    S21ScopedResource scope(&arena);
+    S21Matrix a(40, 40), b(40, 40);
+    randm(a);
+    randm(b);
+    S21Matrix c = a * b + a;
+    EXPECT_EQ(c.getResource(), &arena);
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(c.data()) % 64, 0u);
+    EXPECT_GE(arena.getAllocated(), 3 * 40 * 40 * sizeof(double));
+    // a matrix from outside the scope keeps its own resource
+    outside = outside * outside;
+    EXPECT_NE(outside.getResource(), &arena);
+  }
+  EXPECT_EQ(S21Matrix().getResource(), std::pmr::get_default_resource());
+  arena.Release();
+  EXPECT_EQ(arena.getAllocated(), 0u);
+}
+
+TEST(memory, pool_reuses_blocks) {
+  S21PoolResource pool;
+  const double *first = nullptr;
+  {
+    S21Matrix m(8, 8, &pool);
+    first = m.data();
+  }
+  S21Matrix again(8, 8, &pool);
+  EXPECT_EQ(again.data(), first);
+  S21Matrix large(200, 200, &pool);
+  large(199, 199) = 1;
+  EXPECT_EQ(large(199, 199), 1);
+}
+
+TEST(memory, move_between_resources) {
+  S21ArenaResource arena;
+  S21Matrix heap(2, 2);
+  S21Matrix temp(2, 2, &arena);
+  temp(1, 0) = 5;
+  const double *buffer = temp.data();
+  heap = std::move(temp);
+  EXPECT_NE(heap.data(), buffer);
+  EXPECT_EQ(heap(1, 0), 5);
+  EXPECT_EQ(heap.getResource(), std::pmr::get_default_resource());
+  S21Matrix stolen(std::move(heap));
+  EXPECT_EQ(stolen(1, 0), 5);
+  S21Matrix in_arena(3, 3, &arena);
+  S21Matrix copy(in_arena);
+  EXPECT_EQ(copy.getResource(), std::pmr::get_default_resource());
+}
+
+TEST(view, slicing) {
+  S21Matrix m(4, 5);
+  for (int i = 0; i < 4; i++)
+    for (int j = 0; j < 5; j++) m(i, j) = i * 10 + j;
+  S21MatrixView v(m);
+  EXPECT_EQ(v.Row(2)(0, 3), 23);
+  EXPECT_EQ(v.Col(4)(3, 0), 34);
+  S21MatrixView block = v.Block(1, 1, 2, 3);
+  EXPECT_EQ(block(1, 2), 23);
+  block(0, 0) = -1;
+  EXPECT_EQ(m(1, 1), -1);
+  S21ConstMatrixView strided = v.Strided(0, 0, 2, 3, 2, 2);
+  EXPECT_EQ(strided(1, 2), 24);
+  EXPECT_EQ(v.Transposed()(4, 1), 14);
+  EXPECT_THROW((void)v.Block(3, 0, 2, 1), std::out_of_range);
+  EXPECT_THROW((void)v.Strided(0, 0, 3, 1, 2, 1), std::out_of_range);
+  EXPECT_THROW(v(4, 0), std::out_of_range);
+}
+
+TEST(view, external_buffer) {
+  double buffer[] = {1, 2, 0, 3, 4, 0};
+  S21ConstMatrixView v(buffer, 2, 2, 3);
+  EXPECT_EQ(v.Determinant(), -2);
+  S21Matrix expected(2, 2);
+  expected(0, 0) = 1;
+  expected(0, 1) = 3;
+  expected(1, 0) = 2;
+  expected(1, 1) = 4;
+  EXPECT_TRUE(v.Transpose() == expected);
+  EXPECT_TRUE(v.Transposed().EqMatrix(expected));
+  S21Matrix inverse = v.InverseMatrix();
+  EXPECT_NEAR(inverse(0, 0), -2, 1e-12);
+  EXPECT_NEAR(inverse(1, 1), -0.5, 1e-12);
+}
+
+TEST(view, read_only_ops_match_matrix) {
+  S21Matrix m(9, 9);
+  randm(m);
+  for (int i = 0; i < 9; i++) m(i, i) += 40;
+  S21ConstMatrixView block = S21ConstMatrixView(m).Block(2, 3, 5, 5);
+  S21Matrix copy = block;
+  EXPECT_NEAR(block.Determinant(), copy.Determinant(), 1e-6);
+  EXPECT_TRUE(block.CalcComplements() == copy.CalcComplements());
+  EXPECT_TRUE(block.InverseMatrix() == copy.InverseMatrix());
+  EXPECT_TRUE(block.Transpose() == copy.Transpose());
+  S21Matrix b(5, 2);
+  randm(b);
+  EXPECT_TRUE(block.Solve(b) == copy.Solve(b));
+  EXPECT_TRUE(block == copy);
+  EXPECT_FALSE(block.EqMatrix(S21ConstMatrixView(m).Block(0, 0, 5, 5)));
+}
+
+TEST(view, expressions_and_assign) {
+  S21Matrix m(4, 4), n(2, 2);
+  randm(m);
+  randm(n);
+  S21MatrixView v(m);
+  S21Matrix sum = v.Block(0, 0, 2, 2) + n;
+  EXPECT_EQ(sum(1, 1), m(1, 1) + n(1, 1));
+  const double corner = m(2, 2);
+  v.Block(2, 2, 2, 2).Assign(v.Block(2, 2, 2, 2) * 2.0 - n);
+  EXPECT_EQ(m(2, 2), corner * 2 - n(0, 0));
+  EXPECT_THROW(v.Block(0, 0, 2, 2).Assign(m * 1.0), std::out_of_range);
+  n += v.Block(0, 2, 2, 2).Transposed() * 0.0;
+  EXPECT_TRUE(n == sum - S21MatrixView(m).Block(0, 0, 2, 2));
+}
+
+TEST(view, expressions_reading_the_destination) {
+  S21Matrix a(4, 4), b(4, 4);
+  randm(a);
+  randm(b);
+  const S21Matrix at = a.Transpose();
+  S21Matrix c = a;
+  c = S21MatrixView(c).Transposed() + b;
+  EXPECT_TRUE(c == at + b);
+  c = a;
+  c += S21MatrixView(c).Transposed() * 2.0;
+  EXPECT_TRUE(c == a + at * 2.0);
+  // every row reads row 0 of the destination
+  c = a;
+  c += S21MatrixView(c.data(), 4, 4, 0) * -1.0;
+  for (int j = 0; j < 4; j++) {
+    EXPECT_EQ(c(0, j), 0);
+    EXPECT_EQ(c(3, j), a(3, j) - a(0, j));
+  }
+  // a view laid out like the destination still evaluates in place
+  c = a;
+  const double *buffer = c.data();
+  c += S21MatrixView(c).Block(0, 0, 4, 4);
+  EXPECT_EQ(c.data(), buffer);
+  EXPECT_TRUE(c == a * 2.0);
+}
+
+TEST(multiply, transposed_operands) {
+  const S21Transpose no = S21Transpose::kNo, yes = S21Transpose::kYes;
+  S21Matrix a(37, 20), b(20, 45);
+  randm(a);
+  randm(b);
+  const S21Matrix expected = a * b;
+  const S21Matrix at = a.Transpose(), bt = b.Transpose();
+  S21Matrix c;
+  S21Matrix::Multiply(c, at, b, 1.0, 0.0, yes, no);
+  EXPECT_TRUE(c == expected);
+  S21Matrix::Multiply(c, a, bt, 1.0, 0.0, no, yes);
+  EXPECT_TRUE(c == expected);
+  S21Matrix::Multiply(c, at, bt, 1.0, 0.0, yes, yes);
+  EXPECT_TRUE(c == expected);
+  EXPECT_EQ(c.getRows(), 37);
+  EXPECT_EQ(c.getCols(), 45);
+}
+
+TEST(multiply, accumulate) {
+  S21Matrix a(6, 4), b(4, 5), c(6, 5);
+  randm(a);
+  randm(b);
+  randm(c);
+  const double *buffer = c.data();
+  S21Matrix expected = (a * b) * 2.0 + c * -0.5;
+  S21Matrix::Multiply(c, a, b, 2.0, -0.5);
+  EXPECT_TRUE(c == expected);
+  EXPECT_EQ(c.data(), buffer);
+  S21Matrix wrong(5, 5);
+  EXPECT_THROW(S21Matrix::Multiply(wrong, a, b, 1.0, 1.0), std::out_of_range);
+  EXPECT_THROW(S21Matrix::Multiply(c, a, a), std::out_of_range);
+}
+
+TEST(multiply, aliasing) {
+  S21Matrix a(5, 5), b(5, 5);
+  randm(a);
+  randm(b);
+  S21Matrix expected = a.Transpose() * a + a * 3.0;
+  S21Matrix::Multiply(a, a, a, 1.0, 3.0, S21Transpose::kYes);
+  EXPECT_TRUE(a == expected);
+  expected = b * b;
+  b *= b;
+  EXPECT_TRUE(b == expected);
+}
+
+TEST(multiply, strassen) {
+  // integer inputs keep both paths exact; odd sizes exercise the peeling
+  const int shapes[][3] = {{64, 64, 64}, {67, 45, 53}, {33, 70, 9}};
+  for (const auto &shape : shapes) {
+    S21Matrix a(shape[0], shape[1]), b(shape[1], shape[2]);
+    randm(a);
+    randm(b);
+    const S21Matrix expected = a * b;
+    for (int cutoff : {1, 4, 16, 512}) {
+      S21Matrix c;
+      S21Matrix::MultiplyStrassen(c, a, b, cutoff);
+      EXPECT_TRUE(c == expected);
+    }
+  }
+  // reuses a C of the right shape, and C may alias an operand
+  S21Matrix a(40, 40), b(40, 40), c(40, 40);
+  randm(a);
+  randm(b);
+  const double *buffer = c.data();
+  S21Matrix::MultiplyStrassen(c, a, b, 8);
+  EXPECT_EQ(c.data(), buffer);
+  EXPECT_TRUE(c == a * b);
+  const S21Matrix expected = a * a;
+  S21Matrix::MultiplyStrassen(a, a, a, 8);
+  EXPECT_TRUE(a == expected);
+  S21MatrixCD x(19, 19), y(19, 19), z;
+  for (int i = 0; i < 19; i++)
+    for (int j = 0; j < 19; j++) {
+      x(i, j) = {double(i - j), double(i % 3)};
+      y(i, j) = {double(j % 4), double(i + j)};
+    }
+  S21MatrixCD::MultiplyStrassen(z, x, y, 2);
+  EXPECT_TRUE(z == x * y);
+  EXPECT_THROW(S21Matrix::MultiplyStrassen(c, a, S21Matrix(3, 3)),
+               std::out_of_range);
+  EXPECT_THROW(S21Matrix::MultiplyStrassen(c, a, b, 0), std::out_of_range);
+}
+
+// Dense matrix with roughly one non-zero in `every` elements
+S21Matrix random_sparse(int rows, int cols, int every) {
+  S21Matrix m(rows, cols);
+  for (int i = 0; i < rows; i++)
+    for (int j = 0; j < cols; j++)
+      if (rand() % every == 0) m(i, j) = rand() % 9 + 1;
+  return m;
+}
+
+TEST(sparse, dense_round_trip) {
+  S21Matrix dense = random_sparse(30, 17, 5);
+  for (auto format : {S21SparseFormat::kCsr, S21SparseFormat::kCsc}) {
+    S21SparseMatrix sparse(dense, format);
+    EXPECT_EQ(sparse.getFormat(), format);
+    EXPECT_TRUE(sparse.ToMatrix() == dense);
+    EXPECT_EQ(sparse(3, 4), dense(3, 4));
+    long count = 0;
+    for (int i = 0; i < 30; i++)
+      for (int j = 0; j < 17; j++) count += dense(i, j) != 0;
+    EXPECT_EQ(sparse.NonZeros(), count);
+  }
+  S21SparseMatrix csr(dense);
+  EXPECT_TRUE(csr.Convert(S21SparseFormat::kCsc) == csr);
+  EXPECT_TRUE(S21Matrix(csr.Convert(S21SparseFormat::kCsc)) == dense);
+  EXPECT_THROW((void)csr(30, 0), std::out_of_range);
+}
+
+TEST(sparse, from_triplets) {
+  std::vector<S21SparseTriplet<double>> triplets = {
+      {2, 1, 1.5}, {0, 0, 2}, {2, 1, 0.5}, {1, 3, -1}, {0, 2, 4}, {1, 3, 1}};
+  S21SparseMatrix m = S21SparseMatrix::FromTriplets(3, 4, triplets);
+  EXPECT_EQ(m.NonZeros(), 3);
+  EXPECT_EQ(m(2, 1), 2);
+  EXPECT_EQ(m(1, 3), 0);
+  EXPECT_EQ(m(0, 2), 4);
+  triplets.push_back({3, 0, 1});
+  EXPECT_THROW(S21SparseMatrix::FromTriplets(3, 4, triplets),
+               std::out_of_range);
+}
+
+TEST(sparse, arithmetic) {
+  S21Matrix a = random_sparse(20, 25, 4), b = random_sparse(20, 25, 4);
+  S21SparseMatrix sa(a), sb(b, S21SparseFormat::kCsc);
+  EXPECT_TRUE((sa + sb).ToMatrix() == a + b);
+  EXPECT_TRUE((sa - sb).ToMatrix() == a - b);
+  EXPECT_TRUE((sa * 3.0).ToMatrix() == a * 3.0);
+  EXPECT_TRUE(sa.Transpose().ToMatrix() == a.Transpose());
+  EXPECT_EQ(sa.Transpose().getFormat(), S21SparseFormat::kCsc);
+  S21SparseMatrix zero = sa - sa;
+  EXPECT_EQ(zero.NonZeros(), 0);
+  sa *= 0.0;
+  EXPECT_EQ(sa.NonZeros(), 0);
+  EXPECT_THROW(sa += S21SparseMatrix(25, 20), std::out_of_range);
+}
+
+TEST(sparse, products) {
+  S21Matrix a = random_sparse(40, 30, 6), b = random_sparse(30, 50, 6);
+  S21Matrix dense(30, 7);
+  randm(dense);
+  const S21Matrix expected = a * b;
+  for (auto fa : {S21SparseFormat::kCsr, S21SparseFormat::kCsc}) {
+    for (auto fb : {S21SparseFormat::kCsr, S21SparseFormat::kCsc}) {
+      S21SparseMatrix sa(a, fa), sb(b, fb);
+      S21SparseMatrix product = sa * sb;
+      EXPECT_EQ(product.getFormat(), fa);
+      EXPECT_TRUE(product.ToMatrix() == expected);
+      EXPECT_TRUE(a.Transpose() * S21SparseMatrix(a, fb) ==
+                  a.Transpose() * a);
+    }
+    EXPECT_TRUE(S21SparseMatrix(a, fa) * dense == a * dense);
+  }
+  EXPECT_THROW(S21SparseMatrix(a) * S21SparseMatrix(a), std::out_of_range);
+  EXPECT_THROW((void)(S21SparseMatrix(a) * a), std::out_of_range);
+
+  // (0, 0) cancels exactly and is pruned without shifting later rows
+  S21Matrix c(2, 2), d(2, 2);
+  c(0, 0) = c(0, 1) = c(1, 0) = 1;
+  d(0, 0) = 1, d(0, 1) = 2, d(1, 0) = -1, d(1, 1) = 3;
+  for (auto fc : {S21SparseFormat::kCsr, S21SparseFormat::kCsc}) {
+    const S21SparseMatrix p = S21SparseMatrix(c, fc) * S21SparseMatrix(d, fc);
+    EXPECT_EQ(p.NonZeros(), 3);
+    EXPECT_EQ(p(0, 0), 0);
+    EXPECT_EQ(p(1, 0), 1);
+    EXPECT_TRUE(p.ToMatrix() == c * d);
+  }
+}
+
+TEST(batch, matches_single_matrices) {
+  for (int n : {4, 6}) {
+    const int count = 37;
+    S21BatchMatrix a(count, n, n), b(count, n, n);
+    std::vector<S21Matrix> as, bs;
+    for (int k = 0; k < count; k++) {
+      S21Matrix x(n, n), y(n, n);
+      randm(x);
+      randm(y);
+      for (int i = 0; i < n; i++) x(i, i) += 20;
+      a.Set(k, x);
+      b.Set(k, y);
+      as.push_back(x);
+      bs.push_back(y);
+    }
+    const S21BatchMatrix product = a * b;
+    const S21BatchMatrix transpose = a.Transpose();
+    const S21BatchMatrix inverse = a.InverseMatrix();
+    const std::vector<double> det = a.Determinant();
+    ASSERT_EQ(det.size(), static_cast<std::size_t>(count));
+    for (int k = 0; k < count; k++) {
+      EXPECT_TRUE(product.Get(k) == as[k] * bs[k]);
+      EXPECT_TRUE(transpose.Get(k) == as[k].Transpose());
+      EXPECT_TRUE(inverse.Get(k) == as[k].InverseMatrix());
+      EXPECT_NEAR(det[k], as[k].Determinant(), 1e-9 * std::abs(det[k]));
+    }
+    // output reused, then aliased with the left operand
+    S21BatchMatrix c(count, n, n);
+    S21BatchMatrix::Multiply(c, a, b);
+    a.MulMatrix(b);
+    for (int k = 0; k < count; k++) {
+      EXPECT_TRUE(c.Get(k) == product.Get(k));
+      EXPECT_TRUE(a.Get(k) == product.Get(k));
+    }
+  }
+}
+
+TEST(batch, pivoting_and_singular) {
+  S21BatchMatrix a(3, 3, 3);
+  S21Matrix swap(3, 3), singular(3, 3), identity(3, 3);
+  // needs a row exchange in the first column
+  swap(0, 1) = 2;
+  swap(1, 0) = 3;
+  swap(2, 2) = 1;
+  for (int i = 0; i < 3; i++) {
+    identity(i, i) = 1;
+    for (int j = 0; j < 3; j++) singular(i, j) = i * 3 + j + 1;
+  }
+  a.Set(0, swap);
+  a.Set(1, identity);
+  a.Set(2, singular);
+  const std::vector<double> det = a.Determinant();
+  EXPECT_DOUBLE_EQ(det[0], -6);
+  EXPECT_DOUBLE_EQ(det[1], 1);
+  EXPECT_DOUBLE_EQ(det[2], 0);
+  EXPECT_THROW((void)a.InverseMatrix(), std::out_of_range);
+  a.Set(2, identity);
+  EXPECT_TRUE(a.InverseMatrix().Get(0) == swap.InverseMatrix());
+  EXPECT_THROW(a(3, 0, 0), std::out_of_range);
+  EXPECT_THROW(a.Set(0, S21Matrix(2, 2)), std::out_of_range);
+  EXPECT_THROW(a.Set(3, identity), std::out_of_range);
+  EXPECT_THROW((void)a.Get(-1), std::out_of_range);
+  EXPECT_THROW(S21BatchMatrix(0, 2, 2), std::out_of_range);
+  // small scale is not singular, the batch agrees with S21Matrix
+  S21BatchMatrix small(9, 4, 4);
+  S21Matrix scaled(4, 4);
+  for (int i = 0; i < 4; i++) scaled(i, i) = 1e-8;
+  for (int k = 0; k < 9; k++) small.Set(k, scaled);
+  const S21BatchMatrix inverse = small.InverseMatrix();
+  for (int k = 0; k < 9; k++)
+    EXPECT_TRUE(inverse.Get(k) * 1e-8 == scaled.InverseMatrix() * 1e-8);
+}
+
 int main() {
   testing::InitGoogleTest();
   return RUN_ALL_TESTS();
   return 0;
-}
\ No newline at end of file
+}
+TEST(io, save_load_round_trip) {
+  const char *path = "s21_matrix_test.bin";
+  S21Matrix a(37, 21);
+  randm(a);
+  S21SaveMatrix(a, path);
+  const S21MatrixFileInfo info = S21ReadMatrixInfo(path);
+  EXPECT_EQ(info.rows, 37);
+  EXPECT_EQ(info.cols, 21);
+  EXPECT_EQ(info.type, S21FileType::kDouble);
+  const S21Matrix b = S21LoadMatrix<double>(path);
+  for (int i = 0; i < a.getRows(); i++)
+    for (int j = 0; j < a.getCols(); j++) EXPECT_EQ(a(i, j), b(i, j));
+  // a strided view is written densely
+  S21MatrixView block = S21MatrixView(a).Block(3, 2, 10, 7).Transposed();
+  S21SaveMatrix(block, path);
+  EXPECT_TRUE(S21LoadMatrix<double>(path) == S21Matrix(block));
+  // other element types, wrong type and corrupt files
+  S21BasicMatrix<std::complex<double>> c(3, 4);
+  for (int i = 0; i < 3; i++)
+    for (int j = 0; j < 4; j++) c(i, j) = std::complex<double>(i, j);
+  S21SaveMatrix(c, path);
+  EXPECT_TRUE(S21LoadMatrix<std::complex<double>>(path) == c);
+  EXPECT_THROW((void)S21LoadMatrix<double>(path), std::runtime_error);
+  // 2^30 x 2^30 elements of 16 bytes wrap the size around to 0
+  std::FILE *file = std::fopen(path, "r+b");
+  ASSERT_NE(file, nullptr);
+  const std::uint64_t huge[2] = {1ULL << 30, 1ULL << 30};
+  std::fseek(file, 16, SEEK_SET);
+  std::fwrite(huge, sizeof(huge), 1, file);
+  std::fclose(file);
+  EXPECT_THROW((void)S21ReadMatrixInfo(path), std::runtime_error);
+  EXPECT_THROW(S21BasicMappedMatrix<std::complex<double>>{path},
+               std::runtime_error);
+  file = std::fopen(path, "r+b");
+  ASSERT_NE(file, nullptr);
+  std::fputs("XXXX", file);
+  std::fclose(file);
+  EXPECT_THROW((void)S21LoadMatrix<std::complex<double>>(path),
+               std::runtime_error);
+  std::remove(path);
+  EXPECT_THROW((void)S21LoadMatrix<double>(path), std::runtime_error);
+}
+
+TEST(io, mapped_matrix) {
+  const char *path = "s21_matrix_mapped.bin";
+  S21Matrix a(64, 33);
+  randm(a);
+  S21SaveMatrix(a, path);
+  S21MappedMatrix mapped(path);
+  EXPECT_EQ(mapped.getRows(), 64);
+  EXPECT_EQ(mapped.getCols(), 33);
+  EXPECT_EQ(reinterpret_cast<std::uintptr_t>(mapped.data()) %
+                S21Matrix::kAlignment,
+            0u);
+  EXPECT_TRUE(mapped.View().EqMatrix(a));
+  const S21MappedMatrix moved = std::move(mapped);
+  const S21Matrix sum = moved.View() + a;
+  EXPECT_TRUE(sum == a * 2.0);
+  std::remove(path);
+  EXPECT_THROW(S21MappedMatrix("s21_matrix_missing.bin"), std::runtime_error);
+}
+
+TEST(text, round_trip_and_formats) {
+  const char *path = "s21_matrix_test.csv";
+  S21Matrix a(50, 7);
+  for (int i = 0; i < 50; i++)
+    for (int j = 0; j < 7; j++) a(i, j) = (rand() - RAND_MAX / 2) / 7.0;
+  S21SaveText(a, path);
+  const S21Matrix b = S21LoadText<double>(path);
+  ASSERT_EQ(b.getRows(), 50);
+  ASSERT_EQ(b.getCols(), 7);
+  for (int i = 0; i < 50; i++)
+    for (int j = 0; j < 7; j++) EXPECT_EQ(a(i, j), b(i, j));
+  S21SaveText(a, path, ' ');
+  EXPECT_TRUE(S21LoadText<double>(path, ' ') == a);
+
+  std::FILE *file = std::fopen(path, "wb");
+  std::fputs("1, 2.5 ,-3\r\n\n  +4,5e1,\t6\n7,8,9", file);
+  std::fclose(file);
+  const S21Matrix c = S21LoadText<double>(path);
+  ASSERT_EQ(c.getRows(), 3);
+  EXPECT_EQ(c(0, 1), 2.5);
+  EXPECT_EQ(c(0, 2), -3);
+  EXPECT_EQ(c(1, 0), 4);
+  EXPECT_EQ(c(1, 1), 50);
+  EXPECT_EQ(c(2, 2), 9);
+
+  for (const char *bad : {"1,2\n3\n", "1,x\n", "1 2\n", "1,,2\n"}) {
+    file = std::fopen(path, "wb");
+    std::fputs(bad, file);
+    std::fclose(file);
+    EXPECT_THROW((void)S21LoadText<double>(path), std::runtime_error) << bad;
+  }
+  std::remove(path);
+}
+
+TEST(text, streaming_chunks) {
+  const char *path = "s21_matrix_stream.txt";
+  S21Matrix a(1000, 3);
+  randm(a);
+  {
+    S21TextWriter writer(path, '\t');
+    for (int first = 0; first < 1000; first += 100)
+      writer.WriteRows(S21MatrixView(a).Block(first, 0, 100, 3));
+    writer.Close();
+  }
+  S21TextReader reader(path, '\t');
+  S21Matrix chunk;
+  int total = 0, rows;
+  while ((rows = reader.ReadRows(chunk, 64)) > 0) {
+    EXPECT_EQ(chunk.getRows(), rows);
+    EXPECT_TRUE(chunk == S21Matrix(S21MatrixView(a).Block(total, 0, rows, 3)));
+    total += rows;
+  }
+  EXPECT_EQ(total, 1000);
+  EXPECT_EQ(reader.getCols(), 3);
+  // lines parsed by the pool, appended in steps
+  S21ThreadPool::SetThreadCount(4);
+  S21ThreadPool::SetSerialThreshold(0);
+  S21TextReader appender(path, '\t');
+  S21Matrix b;
+  EXPECT_EQ(appender.AppendRows(b, 1), 1);
+  while (appender.AppendRows(b, 300) > 0) {
+  }
+  S21ThreadPool::SetSerialThreshold(1L << 18);
+  S21ThreadPool::SetThreadCount(1);
+  EXPECT_TRUE(b == a);
+  std::remove(path);
+}
+
+TEST(tiled, matches_in_memory) {
+  S21Matrix a(45, 37), b(45, 37), c(37, 29);
+  randm(a);
+  randm(b);
+  randm(c);
+  // 16 x 16 tiles with ragged edges, a cache smaller than any operand
+  S21TiledMatrix ta = S21TiledMatrix::FromMatrix("s21_tiled_a.bin", a, 16, 4);
+  S21TiledMatrix tb = S21TiledMatrix::FromMatrix("s21_tiled_b.bin", b, 16, 4);
+  S21TiledMatrix tc = S21TiledMatrix::FromMatrix("s21_tiled_c.bin", c, 16, 4);
+  EXPECT_EQ(ta.TileRows(), 3);
+  EXPECT_EQ(ta.TileCols(), 3);
+  EXPECT_TRUE(ta.ToMatrix() == a);
+  EXPECT_EQ(ta.Get(44, 36), a(44, 36));
+
+  ta.SumMatrix(tb);
+  EXPECT_TRUE(ta.ToMatrix() == a + b);
+  ta.SubMatrix(tb);
+  EXPECT_TRUE(ta.ToMatrix() == a);
+  S21TiledMatrix tt = ta.Transpose("s21_tiled_t.bin");
+  EXPECT_TRUE(tt.ToMatrix() == a.Transpose());
+  S21TiledMatrix product = S21TiledMatrix::Create("s21_tiled_p.bin", 45, 29,
+                                                  16, 4);
+  S21TiledMatrix::Multiply(product, ta, tc);
+  EXPECT_TRUE(product.ToMatrix() == a * c);
+  EXPECT_THROW(S21TiledMatrix::Multiply(product, product, tc),
+               std::out_of_range);
+  ta.MulMatrix(tc);
+  EXPECT_EQ(ta.getCols(), 29);
+  EXPECT_EQ(ta.getPath(), "s21_tiled_a.bin");
+  EXPECT_TRUE(ta.ToMatrix() == a * c);
+  EXPECT_THROW(ta.SumMatrix(tb), std::out_of_range);
+  for (const char *path : {"s21_tiled_b.bin", "s21_tiled_c.bin",
+                           "s21_tiled_t.bin", "s21_tiled_p.bin"})
+    std::remove(path);
+}
+
+TEST(tiled, persists_changes) {
+  const char *path = "s21_tiled_persist.bin";
+  {
+    S21TiledMatrix m = S21TiledMatrix::Create(path, 20, 30, 8, 3);
+    m.Set(19, 29, 5);
+    S21Matrix tile(8, 8);
+    tile(0, 0) = 7;
+    m.SetTile(1, 2, tile);
+    for (int i = 0; i < 20; i++) m.Set(i, 0, i);
+  }
+  S21TiledMatrix m = S21TiledMatrix::Open(path);
+  EXPECT_EQ(m.getRows(), 20);
+  EXPECT_EQ(m.getCols(), 30);
+  EXPECT_EQ(m.Get(19, 29), 5);
+  EXPECT_EQ(m.Get(8, 16), 7);
+  EXPECT_EQ(m.Get(13, 0), 13);
+  EXPECT_EQ(m.Get(13, 1), 0);
+  EXPECT_THROW((void)m.Get(20, 0), std::out_of_range);
+  EXPECT_THROW((void)S21BasicTiledMatrix<float>::Open(path),
+               std::runtime_error);
+  std::remove(path);
+  std::remove("s21_tiled_a.bin");
+}
+
+TEST(stats, snapshot_and_dumps) {
+  S21Stats::Reset();
+  const S21StatsSnapshot before = S21Stats::Snapshot();
+  {
+    S21StatsScope scope(S21StatsOp::kMulMatrix, 10);
+    S21Stats::AddBytes(64);
+    // nested in the same operation: not counted again
+    S21StatsScope nested(S21StatsOp::kMulMatrix, 10);
+  }
+  S21Stats::AddBytes(8);
+  S21Stats::AddCall(S21StatsOp::kMove);
+  const S21StatsSnapshot delta = S21Stats::Snapshot() - before;
+  EXPECT_EQ(delta[S21StatsOp::kMulMatrix].calls, 1u);
+  EXPECT_EQ(delta[S21StatsOp::kMulMatrix].flops, 10u);
+  EXPECT_EQ(delta[S21StatsOp::kMulMatrix].bytes, 64u);
+  EXPECT_EQ(delta[S21StatsOp::kOther].bytes, 8u);
+  EXPECT_EQ(delta[S21StatsOp::kMove].calls, 1u);
+  EXPECT_STREQ(S21Stats::Name(S21StatsOp::kInverseMatrix), "inverse_matrix");
+  const std::string json = delta.ToJson();
+  EXPECT_NE(json.find("\"mul_matrix\": {\"calls\": 1, \"flops\": 10, "
+                      "\"bytes\": 64"),
+            std::string::npos);
+  EXPECT_EQ(json.front(), '{');
+  EXPECT_EQ(json.back(), '}');
+  const std::string text = delta.ToPrometheus();
+  EXPECT_NE(text.find("# TYPE s21_matrix_calls_total counter\n"),
+            std::string::npos);
+  EXPECT_NE(text.find("s21_matrix_calls_total{op=\"mul_matrix\"} 1\n"),
+            std::string::npos);
+  EXPECT_NE(text.find("s21_matrix_allocated_bytes_total{op=\"other\"} 8\n"),
+            std::string::npos);
+  S21Stats::Reset();
+  EXPECT_EQ(S21Stats::Snapshot()[S21StatsOp::kMulMatrix].calls, 0u);
+}
+
+TEST(stats, counts_operations) {
+  if (!S21Stats::kEnabled) GTEST_SKIP() << "built without S21_MATRIX_STATS";
+  S21Matrix a(4, 4), b(4, 4);
+  randm(a);
+  randm(b);
+  for (int i = 0; i < 4; i++) a(i, i) += 50;
+  S21Stats::Reset();
+  a.MulMatrix(b);
+  S21StatsSnapshot s = S21Stats::Snapshot();
+  EXPECT_EQ(s[S21StatsOp::kMulMatrix].calls, 1u);
+  EXPECT_EQ(s[S21StatsOp::kMulMatrix].flops, 2u * 4 * 4 * 4);
+  EXPECT_EQ(s[S21StatsOp::kMulMatrix].bytes, 4u * 4 * sizeof(double));
+  EXPECT_EQ(s[S21StatsOp::kCopy].calls, 0u);
+  // operator+= returns by value: one copy per call
+  S21Stats::Reset();
+  a += b;
+  s = S21Stats::Snapshot();
+  EXPECT_EQ(s[S21StatsOp::kSumMatrix].calls, 1u);
+  EXPECT_EQ(s[S21StatsOp::kCopy].calls, 1u);
+  EXPECT_EQ(s[S21StatsOp::kCopy].bytes, 4u * 4 * sizeof(double));
+  S21Stats::Reset();
+  S21Matrix inverse = a.InverseMatrix();
+  s = S21Stats::Snapshot();
+  EXPECT_EQ(s[S21StatsOp::kInverseMatrix].calls, 1u);
+  EXPECT_EQ(s[S21StatsOp::kLU].calls, 1u);
+  EXPECT_EQ(s[S21StatsOp::kSolve].calls, 1u);
+  EXPECT_GT(s[S21StatsOp::kSolve].flops, 0u);
+  EXPECT_GT(s[S21StatsOp::kInverseMatrix].nanoseconds, 0u);
+  S21Stats::Reset();
+  (void)a.CalcComplements();
+  s = S21Stats::Snapshot();
+  EXPECT_EQ(s[S21StatsOp::kMinor].calls, 0u);
+  EXPECT_EQ(s[S21StatsOp::kLU].calls, 1u);
+  // singular: one LU, then one per minor
+  for (int j = 0; j < 4; j++) a(3, j) = a(0, j);
+  S21Stats::Reset();
+  (void)a.CalcComplements();
+  s = S21Stats::Snapshot();
+  EXPECT_EQ(s[S21StatsOp::kMinor].calls, 16u);
+  EXPECT_EQ(s[S21StatsOp::kLU].calls, 17u);
+  S21Stats::Reset();
+}
@@ -0,0 +1,348 @@
+#include "s21_matrix_text.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+#include "s21_thread_pool.h"
+
+namespace {
+
+// Size of the read and write buffers
+constexpr std::size_t kChunk = 1 << 20;
+// Longest std::to_chars output of any element type plus a delimiter
+constexpr std::size_t kMaxField = 64;
+
+bool is_blank(char c) noexcept { return c == ' ' || c == '\t'; }
+
+const char *skip_blanks(const char *p, const char *last) noexcept {
+  while (p != last && is_blank(*p)) p++;
+  return p;
+}
+
+std::FILE *open_file(const std::string &path, const char *mode) {
+  std::FILE *file = std::fopen(path.c_str(), mode);
+  if (file == nullptr)
+    throw std::runtime_error("Error! Cannot open file (" +
+                             std::string(std::strerror(errno)) +
+                             "): " + path);
+  // Both sides already work on whole chunks
+  std::setvbuf(file, nullptr, _IONBF, 0);
+  return file;
+}
+
+}  // namespace
+
+// Reader
+
+template <typename T>
+S21BasicTextReader<T>::S21BasicTextReader(const std::string &path,
+                                          char delimiter)
+    : file_(open_file(path, "rb")),
+      path_(path),
+      delimiter_(delimiter),
+      buffer_(kChunk),
+      begin_(0),
+      complete_(0),
+      end_(0),
+      eof_(false),
+      line_(0),
+      position_(0),
+      cols_(0) {}
+
+template <typename T>
+S21BasicTextReader<T>::~S21BasicTextReader() {
+  std::fclose(file_);
+}
+
+template <typename T>
+void S21BasicTextReader<T>::fail(const std::string &what, long line) const {
+  throw std::runtime_error("Error! " + what + " at line " +
+                           std::to_string(line) + ": " + path_);
+}
+
+template <typename T>
+long S21BasicTextReader<T>::FileSize() const {
+  const long position = std::ftell(file_);
+  std::fseek(file_, 0, SEEK_END);
+  const long size = std::ftell(file_);
+  std::fseek(file_, position, SEEK_SET);
+  return size;
+}
+
+template <typename T>
+bool S21BasicTextReader<T>::refill() {
+  // the partial last line moves to the front, new data goes behind it
+  std::memmove(buffer_.data(), buffer_.data() + begin_, end_ - begin_);
+  end_ -= begin_;
+  begin_ = complete_ = 0;
+  while (!eof_) {
+    if (end_ == buffer_.size()) buffer_.resize(buffer_.size() * 2);
+    const std::size_t got =
+        std::fread(buffer_.data() + end_, 1, buffer_.size() - end_, file_);
+    if (got == 0) {
+      if (std::ferror(file_)) fail("Cannot read file", line_ + 1);
+      eof_ = true;
+      break;
+    }
+    const char *first = buffer_.data() + end_;
+    end_ += got;
+    for (const char *p = buffer_.data() + end_; p != first;) {
+      if (*--p == '\n') {
+        complete_ = p + 1 - buffer_.data();
+        return true;
+      }
+    }
+  }
+  complete_ = end_;
+  return end_ > 0;
+}
+
+template <typename T>
+void S21BasicTextReader<T>::take_lines(int max_lines) {
+  lines_.clear();
+  while (lines_.empty()) {
+    if (begin_ == complete_ && !refill()) return;
+    const char *data = buffer_.data();
+    const char *p = data + begin_;
+    const char *end = data + complete_;
+    while (p != end && static_cast<int>(lines_.size()) < max_lines) {
+      const char *newline =
+          static_cast<const char *>(std::memchr(p, '\n', end - p));
+      const char *last = newline != nullptr ? newline : end;
+      const char *next = newline != nullptr ? newline + 1 : end;
+      line_++;
+      if (last != p && last[-1] == '\r') last--;
+      if (skip_blanks(p, last) != last)
+        lines_.push_back({static_cast<std::size_t>(p - data),
+                          static_cast<std::size_t>(last - data), line_});
+      p = next;
+    }
+    position_ += p - (data + begin_);
+    begin_ = p - data;
+  }
+}
+
+template <typename T>
+int S21BasicTextReader<T>::parse_line(const Line &line, T *out) {
+  const bool to_fields = out == nullptr;
+  if (to_fields) fields_.clear();
+  const char *p = buffer_.data() + line.first;
+  const char *last = buffer_.data() + line.last;
+  int cols = 0;
+  p = skip_blanks(p, last);
+  while (true) {
+    if (p != last && *p == '+') p++;
+    T value;
+    const std::from_chars_result result = std::from_chars(p, last, value);
+    if (result.ec == std::errc::result_out_of_range)
+      fail("Number out of range", line.number);
+    p = result.ptr;
+    if (result.ec != std::errc() ||
+        (p != last && !is_blank(*p) && *p != delimiter_))
+      fail("Invalid number", line.number);
+    if (to_fields) {
+      fields_.push_back(value);
+    } else {
+      if (cols == cols_) fail("Rows have different lengths", line.number);
+      out[cols] = value;
+    }
+    cols++;
+    p = skip_blanks(p, last);
+    if (p == last) break;
+    if (!is_blank(delimiter_)) {
+      if (*p != delimiter_) fail("Missing delimiter", line.number);
+      p = skip_blanks(p + 1, last);
+    }
+  }
+  if (cols_ != 0 && cols != cols_)
+    fail("Rows have different lengths", line.number);
+  return cols;
+}
+
+template <typename T>
+bool S21BasicTextReader<T>::first_row() {
+  take_lines(1);
+  if (lines_.empty()) return false;
+  const int cols = parse_line(lines_[0], nullptr);
+  if (cols_ == 0) cols_ = cols;
+  return true;
+}
+
+template <typename T>
+int S21BasicTextReader<T>::parse_rows(T *out, long stride, int max_rows) {
+  int rows = 0;
+  while (rows < max_rows) {
+    take_lines(max_rows - rows);
+    if (lines_.empty()) break;
+    const long bytes = lines_.back().last - lines_.front().first;
+    T *first = out + rows * stride;
+    // lines are independent, large batches are parsed by the pool
+    S21ThreadPool::ParallelFor(
+        0, static_cast<long>(lines_.size()), bytes, [&](long from, long to) {
+          for (long k = from; k < to; k++)
+            parse_line(lines_[k], first + k * stride);
+        });
+    rows += static_cast<int>(lines_.size());
+  }
+  return rows;
+}
+
+template <typename T>
+int S21BasicTextReader<T>::ReadRows(Matrix &chunk, int max_rows) {
+  if (max_rows <= 0)
+    throw std::out_of_range("Incorrect input, size should be positive");
+  // the first row decides whether there is anything to reshape chunk for
+  if (!first_row()) return 0;
+  if (chunk.getCols() != cols_) chunk = Matrix(max_rows, cols_);
+  chunk.reserve(max_rows, cols_);
+  chunk.setRows(max_rows);
+  std::copy_n(fields_.data(), cols_, chunk.data());
+  const int rows =
+      1 + parse_rows(chunk.data() + chunk.stride(), chunk.stride(),
+                     max_rows - 1);
+  chunk.setRows(rows);
+  return rows;
+}
+
+template <typename T>
+int S21BasicTextReader<T>::AppendRows(Matrix &matrix, int max_rows) {
+  if (max_rows <= 0)
+    throw std::out_of_range("Incorrect input, size should be positive");
+  int row = matrix.getRows();
+  const int start = row;
+  if (row == 0 || cols_ == 0) {
+    if (!first_row()) return 0;
+    if (row == 0) {
+      matrix = Matrix(1, cols_);
+    } else {
+      if (matrix.getCols() != cols_)
+        throw std::out_of_range(
+            "Incorrect input, matrices should have the same size");
+      matrix.setRows(row + 1);
+    }
+    std::copy_n(fields_.data(), cols_,
+                matrix.data() + static_cast<long>(row) * matrix.stride());
+    row++;
+  } else if (matrix.getCols() != cols_) {
+    throw std::out_of_range(
+        "Incorrect input, matrices should have the same size");
+  }
+  const int wanted = max_rows - (row - start);
+  // no growth for a reader that has nothing left
+  if (wanted > 0 && (begin_ != complete_ || refill())) {
+    // room for all of them first (amortized growth), unused rows dropped
+    matrix.setRows(row + wanted);
+    row += parse_rows(matrix.data() + static_cast<long>(row) * matrix.stride(),
+                      matrix.stride(), wanted);
+    matrix.setRows(row);
+  }
+  return row - start;
+}
+
+// Writer
+
+template <typename T>
+S21BasicTextWriter<T>::S21BasicTextWriter(const std::string &path,
+                                          char delimiter)
+    : file_(open_file(path, "wb")),
+      path_(path),
+      delimiter_(delimiter),
+      buffer_(kChunk),
+      size_(0) {}
+
+template <typename T>
+S21BasicTextWriter<T>::~S21BasicTextWriter() {
+  if (file_ == nullptr) return;
+  std::fwrite(buffer_.data(), 1, size_, file_);
+  std::fclose(file_);
+}
+
+template <typename T>
+void S21BasicTextWriter<T>::flush_buffer() {
+  if (std::fwrite(buffer_.data(), 1, size_, file_) != size_)
+    throw std::runtime_error("Error! Cannot write file (" +
+                             std::string(std::strerror(errno)) +
+                             "): " + path_);
+  size_ = 0;
+}
+
+template <typename T>
+void S21BasicTextWriter<T>::WriteRows(
+    const S21BasicMatrixView<const T> &rows) {
+  if (file_ == nullptr)
+    throw std::runtime_error("Error! File is closed: " + path_);
+  for (int i = 0; i < rows.getRows(); i++) {
+    for (int j = 0; j < rows.getCols(); j++) {
+      if (buffer_.size() - size_ < kMaxField) flush_buffer();
+      char *out = buffer_.data() + size_;
+      out = std::to_chars(out, buffer_.data() + buffer_.size(),
+                          rows.eval(i, j))
+                .ptr;
+      *out++ = j + 1 < rows.getCols() ? delimiter_ : '\n';
+      size_ = out - buffer_.data();
+    }
+  }
+}
+
+template <typename T>
+void S21BasicTextWriter<T>::Close() {
+  if (file_ == nullptr) return;
+  flush_buffer();
+  std::FILE *file = file_;
+  file_ = nullptr;
+  if (std::fclose(file) != 0)
+    throw std::runtime_error("Error! Cannot write file: " + path_);
+}
+
+// Whole files
+
+template <typename T>
+S21BasicMatrix<T> S21LoadText(const std::string &path, char delimiter) {
+  // Rows appended per step
+  constexpr int kStep = 4096;
+  S21BasicTextReader<T> reader(path, delimiter);
+  S21BasicMatrix<T> sol;
+  if (reader.AppendRows(sol, 1) == 0)
+    throw std::runtime_error("Error! Empty file: " + path);
+  // the first row's length estimates the row count, growth covers the rest
+  const long estimate = reader.FileSize() / std::max(1L, reader.Position());
+  sol.reserve(static_cast<int>(std::min<long>(
+                  estimate + estimate / 8, std::numeric_limits<int>::max())),
+              sol.getCols());
+  // fills the reserved rows first, grows only once they are used up
+  while (reader.AppendRows(sol, std::max(kStep, sol.row_capacity() -
+                                                    sol.getRows())) > 0) {
+  }
+  return sol;
+}
+
+template <typename T>
+void S21SaveText(const S21BasicMatrix<T> &matrix, const std::string &path,
+                 char delimiter) {
+  S21BasicTextWriter<T> writer(path, delimiter);
+  writer.WriteRows(matrix);
+  writer.Close();
+}
+
+template class S21BasicTextReader<float>;
+template class S21BasicTextReader<double>;
+template class S21BasicTextReader<long double>;
+template class S21BasicTextWriter<float>;
+template class S21BasicTextWriter<double>;
+template class S21BasicTextWriter<long double>;
+
+template S21BasicMatrix<float> S21LoadText<float>(const std::string &, char);
+template S21BasicMatrix<double> S21LoadText<double>(const std::string &,
+                                                    char);
+template S21BasicMatrix<long double> S21LoadText<long double>(
+    const std::string &, char);
+template void S21SaveText(const S21BasicMatrix<float> &, const std::string &,
+                          char);
+template void S21SaveText(const S21BasicMatrix<double> &, const std::string &,
+                          char);
+template void S21SaveText(const S21BasicMatrix<long double> &,
+                          const std::string &, char);
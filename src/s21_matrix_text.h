@@ -0,0 +1,138 @@
+#ifndef MATRIX_SRC_S21_MATRIX_TEXT_H
+#define MATRIX_SRC_S21_MATRIX_TEXT_H
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "s21_matrix_oop.h"
+#include "s21_matrix_view.h"
+
+// Delimited text matrices, one row per line. With a ',' (or any other
+// character) delimiter fields are separated by exactly one delimiter and
+// may be padded with spaces or tabs; with ' ' or '\t' fields are
+// separated by any run of spaces and tabs. Blank lines are skipped and
+// "\r\n" line ends are accepted. Numbers are parsed and printed with
+// std::from_chars and std::to_chars, so writing and reading back gives the
+// same values.
+//
+// Files are processed through a fixed size buffer: the reader hands out
+// any number of rows at a time and never holds more than the longest line
+// plus one buffer, so files larger than memory can be streamed in chunks.
+// The whole lines of a buffer are parsed in parallel when the thread pool
+// has more than one thread. Errors, including malformed numbers and rows
+// of different length, throw std::runtime_error naming the file and line.
+// Real element types only.
+template <typename T>
+class S21BasicTextReader {
+ public:
+  using Matrix = S21BasicMatrix<T>;
+
+ private:
+  // A non-blank line of buffer_ without its end of line
+  struct Line {
+    std::size_t first, last;
+    long number;
+  };
+
+  std::FILE *file_;
+  std::string path_;
+  char delimiter_;
+  std::vector<char> buffer_;
+  std::size_t begin_;        // First unparsed byte of buffer_
+  std::size_t complete_;     // End of the last whole line in buffer_
+  std::size_t end_;          // End of the data in buffer_
+  bool eof_;
+  long line_;                // Number of the last line taken
+  long position_;            // File offset after the last line taken
+  int cols_;                 // 0 until the first row is read
+  std::vector<T> fields_;    // Values of a row of unknown length
+  std::vector<Line> lines_;  // Lines taken for the current batch
+
+  // Reads on so that [begin_, complete_) holds whole lines again; false
+  // at the end of the file
+  bool refill();
+  // Takes up to max_lines non-blank lines into lines_, all from the
+  // current buffer contents; none at the end of the file
+  void take_lines(int max_lines);
+  // Parses a line into out[0, cols_), or into fields_ when out is null;
+  // returns the number of fields
+  int parse_line(const Line &line, T *out);
+  // Next row into fields_, setting cols_ the first time
+  bool first_row();
+  // Up to max_rows rows into out, stride elements apart; lines of one
+  // buffer are parsed in parallel
+  int parse_rows(T *out, long stride, int max_rows);
+  [[noreturn]] void fail(const std::string &what, long line) const;
+
+ public:
+  explicit S21BasicTextReader(const std::string &path, char delimiter = ',');
+  S21BasicTextReader(const S21BasicTextReader &) = delete;
+  S21BasicTextReader &operator=(const S21BasicTextReader &) = delete;
+  ~S21BasicTextReader();
+
+  // Columns of every row, 0 before the first row has been read
+  [[nodiscard]] int getCols() const noexcept { return cols_; }
+  // Bytes of the file and bytes consumed so far, for sizing the
+  // destination up front
+  [[nodiscard]] long FileSize() const;
+  [[nodiscard]] long Position() const noexcept { return position_; }
+  // Reads up to `max_rows` rows into `chunk`, which takes their shape and
+  // reuses its buffer when big enough. Returns the number of rows read,
+  // 0 at the end of the file (chunk is then left alone).
+  int ReadRows(Matrix &chunk, int max_rows);
+  // Appends up to `max_rows` rows to `matrix` (setRows, amortized
+  // growth) and returns their number, 0 at the end of the file. An empty
+  // matrix takes the shape of the file.
+  int AppendRows(Matrix &matrix, int max_rows);
+};
+
+template <typename T>
+class S21BasicTextWriter {
+ private:
+  std::FILE *file_;
+  std::string path_;
+  char delimiter_;
+  std::vector<char> buffer_;
+  std::size_t size_;  // Bytes of buffer_ in use
+
+  void flush_buffer();
+
+ public:
+  explicit S21BasicTextWriter(const std::string &path, char delimiter = ',');
+  S21BasicTextWriter(const S21BasicTextWriter &) = delete;
+  S21BasicTextWriter &operator=(const S21BasicTextWriter &) = delete;
+  // Flushes; errors of the last write are only reported by Close()
+  ~S21BasicTextWriter();
+
+  // Appends every row of `rows`
+  void WriteRows(const S21BasicMatrixView<const T> &rows);
+  void WriteRows(const S21BasicMatrix<T> &rows) {
+    WriteRows(S21BasicMatrixView<const T>(rows));
+  }
+  void WriteRows(const S21BasicMatrixView<T> &rows) {
+    WriteRows(S21BasicMatrixView<const T>(rows));
+  }
+  // Writes out the buffer and closes the file
+  void Close();
+};
+
+// Whole-file helpers
+template <typename T>
+[[nodiscard]] S21BasicMatrix<T> S21LoadText(const std::string &path,
+                                            char delimiter = ',');
+template <typename T>
+void S21SaveText(const S21BasicMatrix<T> &matrix, const std::string &path,
+                 char delimiter = ',');
+
+using S21TextReader = S21BasicTextReader<double>;
+using S21TextWriter = S21BasicTextWriter<double>;
+
+extern template class S21BasicTextReader<float>;
+extern template class S21BasicTextReader<double>;
+extern template class S21BasicTextReader<long double>;
+extern template class S21BasicTextWriter<float>;
+extern template class S21BasicTextWriter<double>;
+extern template class S21BasicTextWriter<long double>;
+
+#endif  // MATRIX_SRC_S21_MATRIX_TEXT_H
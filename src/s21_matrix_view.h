@@ -0,0 +1,213 @@
+#ifndef MATRIX_SRC_S21_MATRIX_VIEW_H
+#define MATRIX_SRC_S21_MATRIX_VIEW_H
+
+#include <cmath>
+#include <functional>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "s21_matrix_kernels.h"
+#include "s21_matrix_oop.h"
+#include "s21_thread_pool.h"
+
+// Non-owning window on matrix elements: element (i, j) lives at
+// data()[i * rowStride() + j * colStride()]. A view can cover a whole
+// S21BasicMatrix, a row, a column, a block or a strided selection of one,
+// or a buffer owned by someone else; nothing is copied and the viewed
+// storage has to outlive the view. S21BasicMatrixView<const T> is the
+// read-only variant, a mutable view converts to it implicitly. Copy
+// assignment rebinds a view, Assign() writes through it.
+//
+// Views take part in expressions (kept by value inside nodes), so
+// `S21Matrix m = view + other;` and `m += view;` read the elements in
+// place. The read-only matrix operations are available on views as well;
+// the ones that factorize copy the elements once into the factorization.
+template <typename T>
+class S21BasicMatrixView : public S21MatrixExpr<S21BasicMatrixView<T>> {
+ public:
+  using value_type = std::remove_const_t<T>;
+  using real_type = typename S21ScalarTraits<value_type>::real_type;
+  using Matrix = S21BasicMatrix<value_type>;
+  static constexpr bool kExprLeaf = false;
+
+ private:
+  using MatrixRef =
+      std::conditional_t<std::is_const_v<T>, const Matrix &, Matrix &>;
+
+  T *data_;
+  int rows_, cols_;
+  int row_stride_, col_stride_;  // Distances between rows and columns
+
+ public:
+  // rows x cols elements of an external buffer
+  S21BasicMatrixView(T *data, int rows, int cols, int row_stride,
+                     int col_stride = 1)
+      : data_(data),
+        rows_(rows),
+        cols_(cols),
+        row_stride_(row_stride),
+        col_stride_(col_stride) {
+    if (rows_ <= 0 || cols_ <= 0)
+      throw std::out_of_range(
+          "Incorrect input, rows and cols size should be positive");
+    if (row_stride_ < 0 || col_stride_ < 0)
+      throw std::out_of_range(
+          "Incorrect input, strides should not be negative");
+  }
+  S21BasicMatrixView(T *data, int rows, int cols)
+      : S21BasicMatrixView(data, rows, cols, cols) {}
+  // The whole matrix
+  S21BasicMatrixView(MatrixRef m)
+      : S21BasicMatrixView(m.data(), m.getRows(), m.getCols(), m.stride()) {}
+  // A view of a temporary would dangle immediately
+  S21BasicMatrixView(const Matrix &&) = delete;
+  template <typename U, std::enable_if_t<std::is_same_v<const U, T> &&
+                                             !std::is_same_v<U, T>,
+                                         int> = 0>
+  S21BasicMatrixView(const S21BasicMatrixView<U> &other) noexcept
+      : data_(other.data()),
+        rows_(other.getRows()),
+        cols_(other.getCols()),
+        row_stride_(other.rowStride()),
+        col_stride_(other.colStride()) {}
+
+  [[nodiscard]] T *data() const noexcept { return data_; }
+  [[nodiscard]] int getRows() const noexcept { return rows_; }
+  [[nodiscard]] int getCols() const noexcept { return cols_; }
+  [[nodiscard]] int rowStride() const noexcept { return row_stride_; }
+  [[nodiscard]] int colStride() const noexcept { return col_stride_; }
+  [[nodiscard]] value_type eval(int i, int j) const noexcept {
+    return data_[static_cast<long>(i) * row_stride_ +
+                 static_cast<long>(j) * col_stride_];
+  }
+  // Any overlap counts unless this views the destination element for element
+  [[nodiscard]] bool aliases(const value_type *data,
+                             long stride) const noexcept {
+    if (data_ == data && row_stride_ == stride && col_stride_ == 1)
+      return false;
+    const std::less_equal<const value_type *> before;
+    const value_type *last = data_ +
+                             static_cast<long>(rows_ - 1) * row_stride_ +
+                             static_cast<long>(cols_ - 1) * col_stride_;
+    return before(data_, data + (rows_ - 1) * stride + cols_ - 1) &&
+           before(data, last);
+  }
+  T &operator()(int i, int j) const {
+    if (i >= rows_ || j >= cols_)
+      throw std::out_of_range("Error! Value is out of range");
+    if (i < 0 || j < 0)
+      throw std::out_of_range("Error! Values should be positive");
+    return data_[static_cast<long>(i) * row_stride_ +
+                 static_cast<long>(j) * col_stride_];
+  }
+
+  // Slicing, every result views the same storage
+
+  // rows x cols elements starting at (row, col), taking every row_step-th
+  // row and col_step-th column
+  [[nodiscard]] S21BasicMatrixView Strided(int row, int col, int rows,
+                                           int cols, int row_step,
+                                           int col_step) const {
+    if (row < 0 || col < 0 || rows <= 0 || cols <= 0 || row_step <= 0 ||
+        col_step <= 0)
+      throw std::out_of_range("Incorrect input, slice is out of range");
+    if (row + static_cast<long>(rows - 1) * row_step >= rows_ ||
+        col + static_cast<long>(cols - 1) * col_step >= cols_)
+      throw std::out_of_range("Incorrect input, slice is out of range");
+    return S21BasicMatrixView(
+        data_ + static_cast<long>(row) * row_stride_ +
+            static_cast<long>(col) * col_stride_,
+        rows, cols, row_stride_ * row_step, col_stride_ * col_step);
+  }
+  [[nodiscard]] S21BasicMatrixView Block(int row, int col, int rows,
+                                         int cols) const {
+    return Strided(row, col, rows, cols, 1, 1);
+  }
+  [[nodiscard]] S21BasicMatrixView Row(int i) const {
+    return Block(i, 0, 1, cols_);
+  }
+  [[nodiscard]] S21BasicMatrixView Col(int j) const {
+    return Block(0, j, rows_, 1);
+  }
+  [[nodiscard]] S21BasicMatrixView Transposed() const noexcept {
+    S21BasicMatrixView result(*this);
+    std::swap(result.rows_, result.cols_);
+    std::swap(result.row_stride_, result.col_stride_);
+    return result;
+  }
+
+  // Writes expr into the viewed elements. Element (i, j) may read (i, j)
+  // of the view itself, but no other element of the same storage.
+  template <typename E>
+  void Assign(const S21MatrixExpr<E> &expr) const {
+    static_assert(!std::is_const_v<T>, "Cannot assign through a const view");
+    static_assert(std::is_same_v<typename E::value_type, value_type>,
+                  "Expression and view element types should match");
+    const E &e = expr.self();
+    if (e.getRows() != rows_ || e.getCols() != cols_)
+      throw std::out_of_range(
+          "Incorrect input, matrices should have the same size");
+    const long cost = static_cast<long>(rows_) * cols_;
+    S21ThreadPool::ParallelFor(0, rows_, cost, [&](long first, long last) {
+      for (long i = first; i < last; i++) {
+        T *row = data_ + i * row_stride_;
+        const int r = static_cast<int>(i);
+        for (int j = 0; j < cols_; j++)
+          row[static_cast<long>(j) * col_stride_] = e.eval(r, j);
+      }
+    });
+  }
+
+  // Read-only operations, same results as the S21BasicMatrix members
+
+  [[nodiscard]] bool EqMatrix(
+      const S21BasicMatrixView<const value_type> &other) const noexcept {
+    constexpr real_type tolerance = S21ScalarTraits<value_type>::kMinimumDiff;
+    if (rows_ != other.getRows() || cols_ != other.getCols()) return false;
+    for (int i = 0; i < rows_; i++) {
+      if (col_stride_ == 1 && other.colStride() == 1) {
+        if (!s21::vec_equal(data_ + static_cast<long>(i) * row_stride_,
+                            other.data() + static_cast<long>(i) *
+                                               other.rowStride(),
+                            cols_, tolerance))
+          return false;
+        continue;
+      }
+      for (int j = 0; j < cols_; j++) {
+        if (std::abs(eval(i, j) - other.eval(i, j)) >= tolerance)
+          return false;
+      }
+    }
+    return true;
+  }
+  [[nodiscard]] Matrix Transpose() const {
+    if (col_stride_ != 1) return Matrix(Transposed());
+    Matrix sol(cols_, rows_);
+    S21ThreadPool::ParallelFor(
+        0, rows_, static_cast<long>(rows_) * cols_,
+        [&](long first, long last) {
+          s21::transpose(static_cast<int>(last - first), cols_,
+                         data_ + first * row_stride_, row_stride_,
+                         sol.data() + first, sol.stride());
+        });
+    return sol;
+  }
+  [[nodiscard]] S21BasicLU<value_type> LU() const {
+    return S21BasicLU<value_type>(Matrix(*this));
+  }
+  [[nodiscard]] value_type Determinant() const { return LU().Determinant(); }
+  [[nodiscard]] Matrix CalcComplements() const {
+    return Matrix(*this).CalcComplements();
+  }
+  [[nodiscard]] Matrix InverseMatrix() const { return LU().InverseMatrix(); }
+  [[nodiscard]] Matrix Solve(
+      const S21BasicMatrixView<const value_type> &b) const {
+    return LU().Solve(Matrix(b));
+  }
+};
+
+using S21MatrixView = S21BasicMatrixView<double>;
+using S21ConstMatrixView = S21BasicMatrixView<const double>;
+
+#endif  // MATRIX_SRC_S21_MATRIX_VIEW_H
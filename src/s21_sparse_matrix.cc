@@ -0,0 +1,492 @@
+#include "s21_sparse_matrix.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <utility>
+
+#include "s21_thread_pool.h"
+
+// Constructors
+
+template <typename T>
+S21BasicSparseMatrix<T>::S21BasicSparseMatrix() noexcept
+    : rows_(0), cols_(0), format_(S21SparseFormat::kCsr), offsets_(1, 0) {}
+
+template <typename T>
+S21BasicSparseMatrix<T>::S21BasicSparseMatrix(int rows, int cols,
+                                              S21SparseFormat format)
+    : rows_(rows), cols_(cols), format_(format) {
+  if (rows_ <= 0 || cols_ <= 0)
+    throw std::out_of_range(
+        "Incorrect input, rows and cols size should be positive");
+  offsets_.assign(outer_size() + 1, 0);
+}
+
+template <typename T>
+S21BasicSparseMatrix<T>::S21BasicSparseMatrix(const Matrix &dense,
+                                              S21SparseFormat format)
+    : S21BasicSparseMatrix(dense.getRows(), dense.getCols(), format) {
+  const bool csr = format_ == S21SparseFormat::kCsr;
+  for (int k = 0; k < outer_size(); k++) {
+    for (int l = 0; l < inner_size(); l++) {
+      const T value = csr ? dense.eval(k, l) : dense.eval(l, k);
+      if (value == T(0)) continue;
+      indices_.push_back(l);
+      values_.push_back(value);
+    }
+    offsets_[k + 1] = static_cast<long>(values_.size());
+  }
+}
+
+template <typename T>
+S21BasicSparseMatrix<T> S21BasicSparseMatrix<T>::FromTriplets(
+    int rows, int cols, const std::vector<S21SparseTriplet<T>> &triplets,
+    S21SparseFormat format) {
+  S21BasicSparseMatrix sol(rows, cols, format);
+  const bool csr = format == S21SparseFormat::kCsr;
+  for (const auto &t : triplets) {
+    if (t.row < 0 || t.row >= rows || t.col < 0 || t.col >= cols)
+      throw std::out_of_range("Error! Value is out of range");
+  }
+  // counting sort by outer index, then sort and combine every line
+  std::vector<long> start(sol.outer_size() + 1, 0);
+  for (const auto &t : triplets) start[(csr ? t.row : t.col) + 1]++;
+  std::partial_sum(start.begin(), start.end(), start.begin());
+  std::vector<std::pair<int, T>> entries(triplets.size());
+  std::vector<long> next(start.begin(), start.end() - 1);
+  for (const auto &t : triplets) {
+    entries[next[csr ? t.row : t.col]++] = {csr ? t.col : t.row, t.value};
+  }
+  for (int k = 0; k < sol.outer_size(); k++) {
+    auto first = entries.begin() + start[k];
+    auto last = entries.begin() + start[k + 1];
+    std::stable_sort(first, last, [](const auto &a, const auto &b) {
+      return a.first < b.first;
+    });
+    for (auto it = first; it != last;) {
+      const int index = it->first;
+      T sum = T(0);
+      for (; it != last && it->first == index; ++it) sum += it->second;
+      if (sum == T(0)) continue;
+      sol.indices_.push_back(index);
+      sol.values_.push_back(sum);
+    }
+    sol.offsets_[k + 1] = static_cast<long>(sol.values_.size());
+  }
+  return sol;
+}
+
+// Conversions
+
+template <typename T>
+S21BasicSparseMatrix<T> S21BasicSparseMatrix<T>::Convert(
+    S21SparseFormat format) const {
+  if (format == format_) return *this;
+  S21BasicSparseMatrix sol(*this);
+  sol.format_ = format;
+  // counting sort of the entries by their inner index; walking the outer
+  // lines in order leaves every new line sorted
+  sol.offsets_.assign(inner_size() + 1, 0);
+  for (int index : indices_) sol.offsets_[index + 1]++;
+  std::partial_sum(sol.offsets_.begin(), sol.offsets_.end(),
+                   sol.offsets_.begin());
+  std::vector<long> next(sol.offsets_.begin(), sol.offsets_.end() - 1);
+  for (int k = 0; k < outer_size(); k++) {
+    for (long p = offsets_[k]; p < offsets_[k + 1]; p++) {
+      const long q = next[indices_[p]]++;
+      sol.indices_[q] = k;
+      sol.values_[q] = values_[p];
+    }
+  }
+  return sol;
+}
+
+template <typename T>
+S21BasicMatrix<T> S21BasicSparseMatrix<T>::ToMatrix() const {
+  if (rows_ == 0) return Matrix();
+  Matrix sol(rows_, cols_);
+  T *data = sol.data();
+  const long ld = sol.stride();
+  const bool csr = format_ == S21SparseFormat::kCsr;
+  for (int k = 0; k < outer_size(); k++) {
+    for (long p = offsets_[k]; p < offsets_[k + 1]; p++) {
+      if (csr)
+        data[k * ld + indices_[p]] = values_[p];
+      else
+        data[indices_[p] * ld + k] = values_[p];
+    }
+  }
+  return sol;
+}
+
+// Element-wise operations
+
+template <typename T>
+bool S21BasicSparseMatrix<T>::EqMatrix(
+    const S21BasicSparseMatrix &other) const {
+  if (!row_column_equal(other)) return false;
+  if (other.format_ != format_) return EqMatrix(other.Convert(format_));
+  for (int k = 0; k < outer_size(); k++) {
+    long p = offsets_[k], q = other.offsets_[k];
+    const long p_end = offsets_[k + 1], q_end = other.offsets_[k + 1];
+    while (p < p_end || q < q_end) {
+      T a = T(0), b = T(0);
+      if (q == q_end || (p < p_end && indices_[p] < other.indices_[q])) {
+        a = values_[p++];
+      } else if (p == p_end || other.indices_[q] < indices_[p]) {
+        b = other.values_[q++];
+      } else {
+        a = values_[p++];
+        b = other.values_[q++];
+      }
+      if (std::abs(a - b) >= kMinimumDiff) return false;
+    }
+  }
+  return true;
+}
+
+template <typename T>
+void S21BasicSparseMatrix<T>::merge(const S21BasicSparseMatrix &other,
+                                    T sign) {
+  if (!row_column_equal(other))
+    throw std::out_of_range(
+        "Incorrect input, matrices should have the same size");
+  if (other.format_ != format_) {
+    merge(other.Convert(format_), sign);
+    return;
+  }
+  std::vector<long> offsets(offsets_.size(), 0);
+  std::vector<int> indices;
+  std::vector<T> values;
+  indices.reserve(indices_.size() + other.indices_.size());
+  values.reserve(values_.size() + other.values_.size());
+  for (int k = 0; k < outer_size(); k++) {
+    long p = offsets_[k], q = other.offsets_[k];
+    const long p_end = offsets_[k + 1], q_end = other.offsets_[k + 1];
+    while (p < p_end || q < q_end) {
+      int index;
+      T value;
+      if (q == q_end || (p < p_end && indices_[p] < other.indices_[q])) {
+        index = indices_[p];
+        value = values_[p++];
+      } else if (p == p_end || other.indices_[q] < indices_[p]) {
+        index = other.indices_[q];
+        value = sign * other.values_[q++];
+      } else {
+        index = indices_[p];
+        value = values_[p++] + sign * other.values_[q++];
+      }
+      // exact cancellations are dropped to keep the storage minimal
+      if (value == T(0)) continue;
+      indices.push_back(index);
+      values.push_back(value);
+    }
+    offsets[k + 1] = static_cast<long>(values.size());
+  }
+  offsets_ = std::move(offsets);
+  indices_ = std::move(indices);
+  values_ = std::move(values);
+}
+
+template <typename T>
+void S21BasicSparseMatrix<T>::prune() {
+  long kept = 0, begin = 0;
+  for (int k = 0; k < outer_size(); k++) {
+    // offsets_[k] was already rewritten, so row k starts at the saved `begin`
+    const long end = offsets_[k + 1];
+    for (long p = begin; p < end; p++) {
+      if (values_[p] == T(0)) continue;
+      indices_[kept] = indices_[p];
+      values_[kept++] = values_[p];
+    }
+    offsets_[k + 1] = kept;
+    begin = end;
+  }
+  indices_.resize(kept);
+  values_.resize(kept);
+}
+
+template <typename T>
+void S21BasicSparseMatrix<T>::SumMatrix(const S21BasicSparseMatrix &other) {
+  merge(other, T(1));
+}
+
+template <typename T>
+void S21BasicSparseMatrix<T>::SubMatrix(const S21BasicSparseMatrix &other) {
+  merge(other, T(-1));
+}
+
+template <typename T>
+void S21BasicSparseMatrix<T>::MulNumber(const T num) {
+  if (num == T(0)) {
+    std::fill(offsets_.begin(), offsets_.end(), 0);
+    indices_.clear();
+    values_.clear();
+    return;
+  }
+  for (T &value : values_) value *= num;
+}
+
+template <typename T>
+S21BasicSparseMatrix<T> S21BasicSparseMatrix<T>::Transpose() const {
+  S21BasicSparseMatrix sol(*this);
+  std::swap(sol.rows_, sol.cols_);
+  sol.format_ = format_ == S21SparseFormat::kCsr ? S21SparseFormat::kCsc
+                                                 : S21SparseFormat::kCsr;
+  return sol;
+}
+
+// Products
+
+// Gustavson's row-by-row algorithm on CSR operands: row i of the product
+// combines the rows of B selected by the entries of row i of A. A first
+// pass counts the entries of every row so that the second can write them
+// in place; both run in parallel over rows with a dense accumulator per
+// chunk.
+template <typename T>
+void S21BasicSparseMatrix<T>::MulMatrix(const S21BasicSparseMatrix &other) {
+  if (cols_ != other.rows_)
+    throw std::out_of_range(
+        "Incorrect input, matrices should have the same size");
+  const S21BasicSparseMatrix a = Convert(S21SparseFormat::kCsr);
+  const S21BasicSparseMatrix b = other.Convert(S21SparseFormat::kCsr);
+  const int m = rows_, n = other.cols_;
+  const long cost =
+      static_cast<long>(a.NonZeros()) * (b.NonZeros() / b.rows_ + 1);
+
+  std::vector<long> offsets(m + 1, 0);
+  S21ThreadPool::ParallelFor(0, m, cost, [&](long first, long last) {
+    std::vector<long> marker(n, -1);
+    for (long i = first; i < last; i++) {
+      long count = 0;
+      for (long p = a.offsets_[i]; p < a.offsets_[i + 1]; p++) {
+        const int k = a.indices_[p];
+        for (long q = b.offsets_[k]; q < b.offsets_[k + 1]; q++) {
+          if (marker[b.indices_[q]] != i) {
+            marker[b.indices_[q]] = i;
+            count++;
+          }
+        }
+      }
+      offsets[i + 1] = count;
+    }
+  });
+  std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+
+  S21BasicSparseMatrix sol(m, n);
+  std::vector<int> indices(offsets[m]);
+  std::vector<T> values(offsets[m]);
+  S21ThreadPool::ParallelFor(0, m, cost, [&](long first, long last) {
+    std::vector<T> sum(n, T(0));
+    std::vector<char> used(n, 0);
+    for (long i = first; i < last; i++) {
+      int *row = indices.data() + offsets[i];
+      int count = 0;
+      for (long p = a.offsets_[i]; p < a.offsets_[i + 1]; p++) {
+        const int k = a.indices_[p];
+        const T value = a.values_[p];
+        for (long q = b.offsets_[k]; q < b.offsets_[k + 1]; q++) {
+          const int j = b.indices_[q];
+          if (!used[j]) {
+            used[j] = 1;
+            row[count++] = j;
+          }
+          sum[j] += value * b.values_[q];
+        }
+      }
+      std::sort(row, row + count);
+      for (int c = 0; c < count; c++) {
+        values[offsets[i] + c] = sum[row[c]];
+        sum[row[c]] = T(0);
+        used[row[c]] = 0;
+      }
+    }
+  });
+  sol.offsets_ = std::move(offsets);
+  sol.indices_ = std::move(indices);
+  sol.values_ = std::move(values);
+  // cancellations can leave exact zeros in the product
+  sol.prune();
+  *this = sol.Convert(format_);
+}
+
+template <typename T>
+S21BasicMatrix<T> S21BasicSparseMatrix<T>::MulDense(const Matrix &dense) const {
+  if (cols_ != dense.getRows())
+    throw std::out_of_range(
+        "Incorrect input, matrices should have the same size");
+  if (format_ == S21SparseFormat::kCsc)
+    return Convert(S21SparseFormat::kCsr).MulDense(dense);
+  const int n = dense.getCols();
+  Matrix sol(rows_, n);
+  const T *b = dense.data();
+  const long ldb = dense.stride();
+  T *c = sol.data();
+  const long ldc = sol.stride();
+  // row i of the result accumulates the dense rows picked by row i here
+  S21ThreadPool::ParallelFor(
+      0, rows_, NonZeros() * n, [&](long first, long last) {
+        for (long i = first; i < last; i++) {
+          T *row = c + i * ldc;
+          for (long p = offsets_[i]; p < offsets_[i + 1]; p++) {
+            const T value = values_[p];
+            const T *src = b + indices_[p] * ldb;
+            for (int j = 0; j < n; j++) row[j] += value * src[j];
+          }
+        }
+      });
+  return sol;
+}
+
+template <typename T>
+S21BasicMatrix<T> operator*(const S21BasicMatrix<T> &dense,
+                            const S21BasicSparseMatrix<T> &sparse) {
+  if (dense.getCols() != sparse.getRows())
+    throw std::out_of_range(
+        "Incorrect input, matrices should have the same size");
+  const int m = dense.getRows(), n = sparse.getCols();
+  S21BasicMatrix<T> sol(m, n);
+  const T *a = dense.data();
+  const long lda = dense.stride();
+  T *c = sol.data();
+  const long ldc = sol.stride();
+  const auto &offsets = sparse.Offsets();
+  const auto &indices = sparse.Indices();
+  const auto &values = sparse.Values();
+  const bool csr = sparse.getFormat() == S21SparseFormat::kCsr;
+  S21ThreadPool::ParallelFor(
+      0, m, sparse.NonZeros() * m, [&](long first, long last) {
+        for (long i = first; i < last; i++) {
+          const T *row_a = a + i * lda;
+          T *row_c = c + i * ldc;
+          if (csr) {
+            // row i of C combines the sparse rows, weighted by row i of A
+            for (int k = 0; k < dense.getCols(); k++) {
+              if (row_a[k] == T(0)) continue;
+              for (long p = offsets[k]; p < offsets[k + 1]; p++)
+                row_c[indices[p]] += row_a[k] * values[p];
+            }
+          } else {
+            // C(i, j) is row i of A dotted with sparse column j
+            for (int j = 0; j < n; j++) {
+              T sum = T(0);
+              for (long p = offsets[j]; p < offsets[j + 1]; p++)
+                sum += row_a[indices[p]] * values[p];
+              row_c[j] = sum;
+            }
+          }
+        }
+      });
+  return sol;
+}
+
+// overload
+
+template <typename T>
+S21BasicSparseMatrix<T> S21BasicSparseMatrix<T>::operator+(
+    const S21BasicSparseMatrix &A) const {
+  S21BasicSparseMatrix sol(*this);
+  sol.SumMatrix(A);
+  return sol;
+}
+
+template <typename T>
+S21BasicSparseMatrix<T> S21BasicSparseMatrix<T>::operator-(
+    const S21BasicSparseMatrix &A) const {
+  S21BasicSparseMatrix sol(*this);
+  sol.SubMatrix(A);
+  return sol;
+}
+
+template <typename T>
+S21BasicSparseMatrix<T> S21BasicSparseMatrix<T>::operator*(
+    const S21BasicSparseMatrix &A) const {
+  S21BasicSparseMatrix sol(*this);
+  sol.MulMatrix(A);
+  return sol;
+}
+
+template <typename T>
+S21BasicSparseMatrix<T> S21BasicSparseMatrix<T>::operator*(
+    const T number) const {
+  S21BasicSparseMatrix sol(*this);
+  sol.MulNumber(number);
+  return sol;
+}
+
+template <typename T>
+S21BasicMatrix<T> S21BasicSparseMatrix<T>::operator*(const Matrix &A) const {
+  return MulDense(A);
+}
+
+template <typename T>
+bool S21BasicSparseMatrix<T>::operator==(
+    const S21BasicSparseMatrix &A) const {
+  return EqMatrix(A);
+}
+
+template <typename T>
+bool S21BasicSparseMatrix<T>::operator!=(
+    const S21BasicSparseMatrix &A) const {
+  return !EqMatrix(A);
+}
+
+template <typename T>
+S21BasicSparseMatrix<T> &S21BasicSparseMatrix<T>::operator+=(
+    const S21BasicSparseMatrix &A) {
+  SumMatrix(A);
+  return *this;
+}
+
+template <typename T>
+S21BasicSparseMatrix<T> &S21BasicSparseMatrix<T>::operator-=(
+    const S21BasicSparseMatrix &A) {
+  SubMatrix(A);
+  return *this;
+}
+
+template <typename T>
+S21BasicSparseMatrix<T> &S21BasicSparseMatrix<T>::operator*=(
+    const S21BasicSparseMatrix &A) {
+  MulMatrix(A);
+  return *this;
+}
+
+template <typename T>
+S21BasicSparseMatrix<T> &S21BasicSparseMatrix<T>::operator*=(
+    const T number) {
+  MulNumber(number);
+  return *this;
+}
+
+template <typename T>
+T S21BasicSparseMatrix<T>::operator()(int i, int j) const {
+  if (i >= rows_ || j >= cols_)
+    throw std::out_of_range("Error! Value is out of range");
+  if (i < 0 || j < 0)
+    throw std::out_of_range("Error! Values should be positive");
+  const bool csr = format_ == S21SparseFormat::kCsr;
+  const int k = csr ? i : j, index = csr ? j : i;
+  auto first = indices_.begin() + offsets_[k];
+  auto last = indices_.begin() + offsets_[k + 1];
+  auto it = std::lower_bound(first, last, index);
+  if (it == last || *it != index) return T(0);
+  return values_[it - indices_.begin()];
+}
+
+template class S21BasicSparseMatrix<float>;
+template class S21BasicSparseMatrix<double>;
+template class S21BasicSparseMatrix<long double>;
+template class S21BasicSparseMatrix<std::complex<double>>;
+
+template S21BasicMatrix<float> operator*(const S21BasicMatrix<float> &,
+                                         const S21BasicSparseMatrix<float> &);
+template S21BasicMatrix<double> operator*(const S21BasicMatrix<double> &,
+                                          const S21BasicSparseMatrix<double> &);
+template S21BasicMatrix<long double> operator*(
+    const S21BasicMatrix<long double> &,
+    const S21BasicSparseMatrix<long double> &);
+template S21BasicMatrix<std::complex<double>> operator*(
+    const S21BasicMatrix<std::complex<double>> &,
+    const S21BasicSparseMatrix<std::complex<double>> &);
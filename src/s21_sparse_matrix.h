@@ -0,0 +1,132 @@
+#ifndef MATRIX_SRC_S21_SPARSE_MATRIX_H
+#define MATRIX_SRC_S21_SPARSE_MATRIX_H
+
+#include <complex>
+#include <vector>
+
+#include "s21_matrix_oop.h"
+
+// Compressed sparse storage order: CSR keeps each row's non-zeros together
+// (offsets over rows, column indices), CSC each column's (offsets over
+// columns, row indices). The same three arrays serve both.
+enum class S21SparseFormat { kCsr, kCsc };
+
+template <typename T>
+struct S21SparseTriplet {
+  int row, col;
+  T value;
+};
+
+// Sparse matrix whose memory is O(rows or cols + non-zeros). Indices
+// inside each compressed row (column) are sorted and unique, explicit
+// zeros are not stored. Operands of a different format are converted on
+// the fly; results keep the format of the left-hand side. Errors are
+// reported with std::out_of_range like S21BasicMatrix.
+template <typename T>
+class S21BasicSparseMatrix {
+ public:
+  using value_type = T;
+  using real_type = typename S21ScalarTraits<T>::real_type;
+  using Matrix = S21BasicMatrix<T>;
+
+ private:
+  // Attributes
+  int rows_, cols_;
+  S21SparseFormat format_;
+  std::vector<long> offsets_;  // Entries of outer line k: [offsets_[k],
+                               // offsets_[k + 1])
+  std::vector<int> indices_;   // Inner index of every entry
+  std::vector<T> values_;
+
+  static constexpr real_type kMinimumDiff = S21ScalarTraits<T>::kMinimumDiff;
+
+  [[nodiscard]] int outer_size() const noexcept {
+    return format_ == S21SparseFormat::kCsr ? rows_ : cols_;
+  }
+  [[nodiscard]] int inner_size() const noexcept {
+    return format_ == S21SparseFormat::kCsr ? cols_ : rows_;
+  }
+  [[nodiscard]] bool row_column_equal(
+      const S21BasicSparseMatrix &other) const noexcept {
+    return rows_ == other.rows_ && cols_ == other.cols_;
+  }
+  // *this = *this + sign * other, entry by entry
+  void merge(const S21BasicSparseMatrix &other, T sign);
+  // Removes stored exact zeros
+  void prune();
+
+ public:
+  S21BasicSparseMatrix() noexcept;
+  // rows x cols zero matrix
+  S21BasicSparseMatrix(int rows, int cols,
+                       S21SparseFormat format = S21SparseFormat::kCsr);
+  // Keeps the non-zero elements of a dense matrix
+  explicit S21BasicSparseMatrix(const Matrix &dense,
+                                S21SparseFormat format = S21SparseFormat::kCsr);
+  // Assembles from (row, col, value) entries in any order, duplicates
+  // are summed
+  static S21BasicSparseMatrix FromTriplets(
+      int rows, int cols, const std::vector<S21SparseTriplet<T>> &triplets,
+      S21SparseFormat format = S21SparseFormat::kCsr);
+
+  [[nodiscard]] int getRows() const noexcept { return rows_; }
+  [[nodiscard]] int getCols() const noexcept { return cols_; }
+  [[nodiscard]] S21SparseFormat getFormat() const noexcept { return format_; }
+  [[nodiscard]] long NonZeros() const noexcept {
+    return static_cast<long>(values_.size());
+  }
+  // Raw compressed arrays
+  [[nodiscard]] const std::vector<long> &Offsets() const noexcept {
+    return offsets_;
+  }
+  [[nodiscard]] const std::vector<int> &Indices() const noexcept {
+    return indices_;
+  }
+  [[nodiscard]] const std::vector<T> &Values() const noexcept {
+    return values_;
+  }
+
+  // Same matrix stored in the other order
+  [[nodiscard]] S21BasicSparseMatrix Convert(S21SparseFormat format) const;
+  [[nodiscard]] Matrix ToMatrix() const;
+  explicit operator Matrix() const { return ToMatrix(); }
+
+  [[nodiscard]] bool EqMatrix(const S21BasicSparseMatrix &other) const;
+  void SumMatrix(const S21BasicSparseMatrix &other);
+  void SubMatrix(const S21BasicSparseMatrix &other);
+  void MulNumber(const T num);
+  void MulMatrix(const S21BasicSparseMatrix &other);
+  // The transpose of a CSR matrix is the same arrays read as CSC, so the
+  // result has the other format and costs one copy of the arrays
+  [[nodiscard]] S21BasicSparseMatrix Transpose() const;
+  // Sparse x dense product
+  [[nodiscard]] Matrix MulDense(const Matrix &dense) const;
+
+  S21BasicSparseMatrix operator+(const S21BasicSparseMatrix &A) const;
+  S21BasicSparseMatrix operator-(const S21BasicSparseMatrix &A) const;
+  S21BasicSparseMatrix operator*(const S21BasicSparseMatrix &A) const;
+  S21BasicSparseMatrix operator*(const T number) const;
+  Matrix operator*(const Matrix &A) const;
+  bool operator==(const S21BasicSparseMatrix &A) const;
+  bool operator!=(const S21BasicSparseMatrix &A) const;
+  S21BasicSparseMatrix &operator+=(const S21BasicSparseMatrix &A);
+  S21BasicSparseMatrix &operator-=(const S21BasicSparseMatrix &A);
+  S21BasicSparseMatrix &operator*=(const S21BasicSparseMatrix &A);
+  S21BasicSparseMatrix &operator*=(const T number);
+  // Element read, zero when not stored; O(log non-zeros of the line)
+  T operator()(int i, int j) const;
+};
+
+// Dense x sparse product
+template <typename T>
+S21BasicMatrix<T> operator*(const S21BasicMatrix<T> &dense,
+                            const S21BasicSparseMatrix<T> &sparse);
+
+using S21SparseMatrix = S21BasicSparseMatrix<double>;
+
+extern template class S21BasicSparseMatrix<float>;
+extern template class S21BasicSparseMatrix<double>;
+extern template class S21BasicSparseMatrix<long double>;
+extern template class S21BasicSparseMatrix<std::complex<double>>;
+
+#endif  // MATRIX_SRC_S21_SPARSE_MATRIX_H
@@ -0,0 +1,143 @@
+#include "s21_thread_pool.h"
+
+#include <algorithm>
+#include <exception>
+#include <stdexcept>
+
+namespace {
+
+// Set while a thread executes a pool task, nested loops then stay serial
+thread_local bool inside_task = false;
+
+}  // namespace
+
+std::atomic<int> S21ThreadPool::thread_count_{1};
+std::atomic<long> S21ThreadPool::serial_threshold_{1L << 18};
+
+S21ThreadPool::S21ThreadPool() : queued_(0), stop_(false), next_queue_(0) {}
+
+S21ThreadPool::~S21ThreadPool() { Stop(); }
+
+S21ThreadPool &S21ThreadPool::Instance() {
+  static S21ThreadPool pool;
+  return pool;
+}
+
+void S21ThreadPool::SetThreadCount(int count) {
+  if (count < 0)
+    throw std::out_of_range("Incorrect input, thread count can't be negative");
+  if (count == 0)
+    count = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+  S21ThreadPool &pool = Instance();
+  thread_count_ = 1;
+  pool.Stop();
+  pool.Start(count - 1);
+  thread_count_ = count;
+}
+
+int S21ThreadPool::getThreadCount() noexcept { return thread_count_; }
+
+void S21ThreadPool::SetSerialThreshold(long cost) noexcept {
+  serial_threshold_ = cost;
+}
+
+long S21ThreadPool::getSerialThreshold() noexcept { return serial_threshold_; }
+
+bool S21ThreadPool::InsideTask() noexcept { return inside_task; }
+
+void S21ThreadPool::Start(int workers) {
+  stop_ = false;
+  for (int i = 0; i < workers; i++)
+    queues_.push_back(std::make_unique<Queue>());
+  for (int i = 0; i < workers; i++)
+    workers_.emplace_back(&S21ThreadPool::WorkerLoop, this, i);
+}
+
+void S21ThreadPool::Stop() noexcept {
+  {
+    std::lock_guard<std::mutex> lock(sleep_mutex_);
+    stop_ = true;
+  }
+  wake_.notify_all();
+  for (auto &worker : workers_) worker.join();
+  workers_.clear();
+  queues_.clear();
+}
+
+// Takes a task from queue `first` (newest end) or steals from any other
+// queue (oldest end) and runs it.
+bool S21ThreadPool::TryRunOne(std::size_t first) noexcept {
+  const std::size_t count = queues_.size();
+  for (std::size_t n = 0; n < count; n++) {
+    const std::size_t index = (first + n) % count;
+    Queue &queue = *queues_[index];
+    Task task;
+    {
+      std::lock_guard<std::mutex> lock(queue.mutex);
+      if (queue.tasks.empty()) continue;
+      if (n == 0) {
+        task = std::move(queue.tasks.back());
+        queue.tasks.pop_back();
+      } else {
+        task = std::move(queue.tasks.front());
+        queue.tasks.pop_front();
+      }
+    }
+    queued_--;
+    bool outer = inside_task;
+    inside_task = true;
+    task();
+    inside_task = outer;
+    return true;
+  }
+  return false;
+}
+
+void S21ThreadPool::WorkerLoop(std::size_t index) {
+  for (;;) {
+    if (TryRunOne(index)) continue;
+    std::unique_lock<std::mutex> lock(sleep_mutex_);
+    wake_.wait(lock, [this] { return stop_ || queued_ > 0; });
+    if (stop_) return;
+  }
+}
+
+void S21ThreadPool::Run(long begin, long end,
+                        const std::function<void(long, long)> &fn) {
+  const long threads = thread_count_;
+  const long chunks = std::min(end - begin, threads * 4);
+  const long step = (end - begin + chunks - 1) / chunks;
+
+  std::atomic<long> remaining(0);
+  std::exception_ptr error;
+  std::mutex error_mutex;
+  for (long first = begin; first < end; first += step) {
+    const long last = std::min(end, first + step);
+    remaining++;
+    Task task = [&, first, last] {
+      try {
+        fn(first, last);
+      } catch (...) {
+        std::lock_guard<std::mutex> lock(error_mutex);
+        if (!error) error = std::current_exception();
+      }
+      remaining--;
+    };
+    Queue &queue = *queues_[next_queue_++ % queues_.size()];
+    {
+      std::lock_guard<std::mutex> lock(queue.mutex);
+      queue.tasks.push_back(std::move(task));
+    }
+    queued_++;
+  }
+  {
+    std::lock_guard<std::mutex> lock(sleep_mutex_);
+  }
+  wake_.notify_all();
+
+  // the caller works too instead of blocking
+  while (remaining > 0) {
+    if (!TryRunOne(next_queue_ % queues_.size())) std::this_thread::yield();
+  }
+  if (error) std::rethrow_exception(error);
+}
@@ -0,0 +1,82 @@
+#ifndef MATRIX_SRC_S21_THREAD_POOL_H
+#define MATRIX_SRC_S21_THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Opt-in parallel backend of the matrix library. By default the pool has a
+// single thread and every operation runs serially on the caller; after
+// SetThreadCount(n) the heavy operations split their work into chunks that
+// are spread over per-worker deques, idle workers steal from the others.
+class S21ThreadPool {
+ private:
+  using Task = std::function<void()>;
+
+  struct Queue {
+    std::mutex mutex;
+    std::deque<Task> tasks;
+  };
+
+  std::vector<std::unique_ptr<Queue>> queues_;  // One deque per worker
+  std::vector<std::thread> workers_;
+  std::mutex sleep_mutex_;
+  std::condition_variable wake_;
+  std::atomic<long> queued_;  // Tasks pushed but not yet taken
+  bool stop_;
+  std::atomic<unsigned> next_queue_;  // Round-robin position for new tasks
+
+  static std::atomic<int> thread_count_;
+  static std::atomic<long> serial_threshold_;
+
+  S21ThreadPool();
+  void Start(int workers);
+  void Stop() noexcept;
+  void WorkerLoop(std::size_t index);
+  bool TryRunOne(std::size_t first) noexcept;
+  void Run(long begin, long end, const std::function<void(long, long)> &fn);
+  [[nodiscard]] static bool InsideTask() noexcept;
+
+ public:
+  S21ThreadPool(const S21ThreadPool &) = delete;
+  S21ThreadPool &operator=(const S21ThreadPool &) = delete;
+  ~S21ThreadPool();
+
+  static S21ThreadPool &Instance();
+
+  // Number of threads taking part in a parallel operation, the caller
+  // included. 1 (the default) keeps everything serial, 0 means one per
+  // hardware thread. Must not be called while matrix operations run.
+  static void SetThreadCount(int count);
+  [[nodiscard]] static int getThreadCount() noexcept;
+
+  // Operations whose cost (in element updates or multiply-adds) is below
+  // the threshold always run serially.
+  static void SetSerialThreshold(long cost) noexcept;
+  [[nodiscard]] static long getSerialThreshold() noexcept;
+
+  [[nodiscard]] static bool ShouldSplit(long cost) noexcept {
+    return thread_count_.load(std::memory_order_relaxed) > 1 &&
+           cost >= serial_threshold_.load(std::memory_order_relaxed) &&
+           !InsideTask();
+  }
+
+  // Calls fn(first, last) over subranges covering [begin, end) and returns
+  // when all of them finished. Nested calls from inside a task run inline.
+  // The first exception thrown by a chunk is rethrown to the caller.
+  template <typename F>
+  static void ParallelFor(long begin, long end, long cost, F &&fn) {
+    if (end - begin < 2 || !ShouldSplit(cost)) {
+      if (begin < end) fn(begin, end);
+      return;
+    }
+    Instance().Run(begin, end, std::function<void(long, long)>(std::ref(fn)));
+  }
+};
+
+#endif  // MATRIX_SRC_S21_THREAD_POOL_H
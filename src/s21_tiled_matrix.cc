@@ -0,0 +1,518 @@
+#include "s21_tiled_matrix.h"
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+
+#include "s21_matrix_io.h"
+
+namespace {
+
+constexpr char kMagic[4] = {'S', '2', '1', 'T'};
+constexpr std::uint32_t kByteOrder = 0x01020304;
+constexpr std::uint16_t kVersion = 1;
+constexpr std::uint64_t kDataOffset = 64;
+// Below this an operation could evict a tile it is still using
+constexpr int kMinimumCacheTiles = 3;
+
+struct Header {
+  char magic[4];
+  std::uint32_t byte_order;
+  std::uint16_t version;
+  std::uint8_t type;
+  std::uint8_t reserved0;
+  std::uint32_t element_size;
+  std::uint64_t rows;
+  std::uint64_t cols;
+  std::uint64_t tile;
+  std::uint64_t data_offset;
+  std::uint8_t reserved[16];
+};
+static_assert(sizeof(Header) == kDataOffset, "header is one cache line");
+
+[[noreturn]] void fail(const std::string &what, const std::string &path) {
+  throw std::runtime_error("Error! " + what + ": " + path);
+}
+
+[[noreturn]] void fail_errno(const std::string &what,
+                             const std::string &path) {
+  fail(what + " (" + std::strerror(errno) + ")", path);
+}
+
+void read_at(int fd, void *buffer, std::size_t bytes, off_t offset,
+             const std::string &path) {
+  char *p = static_cast<char *>(buffer);
+  while (bytes > 0) {
+    const ssize_t done = ::pread(fd, p, bytes, offset);
+    if (done < 0 && errno == EINTR) continue;
+    if (done < 0) fail_errno("Cannot read file", path);
+    if (done == 0) fail("Unexpected end of file", path);
+    p += done;
+    bytes -= done;
+    offset += done;
+  }
+}
+
+void write_at(int fd, const void *buffer, std::size_t bytes, off_t offset,
+              const std::string &path) {
+  const char *p = static_cast<const char *>(buffer);
+  while (bytes > 0) {
+    const ssize_t done = ::pwrite(fd, p, bytes, offset);
+    if (done < 0 && errno == EINTR) continue;
+    if (done <= 0) fail_errno("Cannot write file", path);
+    p += done;
+    bytes -= done;
+    offset += done;
+  }
+}
+
+template <typename T>
+off_t tile_offset(long key, int tile) {
+  return static_cast<off_t>(kDataOffset) +
+         static_cast<off_t>(key) * tile * tile * sizeof(T);
+}
+
+// Runs on the prefetch threads as well, so it only touches its arguments
+template <typename T>
+S21BasicMatrix<T> read_tile(int fd, const std::string &path, int tile,
+                            long key) {
+  S21BasicMatrix<T> sol(tile, tile);
+  read_at(fd, sol.data(), sizeof(T) * tile * tile, tile_offset<T>(key, tile),
+          path);
+  return sol;
+}
+
+int tiles(int size, int tile) { return (size + tile - 1) / tile; }
+
+}  // namespace
+
+template <typename T>
+S21BasicTiledMatrix<T>::S21BasicTiledMatrix(int fd, std::string path,
+                                            int rows, int cols, int tile,
+                                            int cache_tiles)
+    : fd_(fd),
+      path_(std::move(path)),
+      rows_(rows),
+      cols_(cols),
+      tile_(tile),
+      tile_rows_(tiles(rows, tile)),
+      tile_cols_(tiles(cols, tile)),
+      cache_tiles_(cache_tiles) {}
+
+template <typename T>
+S21BasicTiledMatrix<T> S21BasicTiledMatrix<T>::Create(const std::string &path,
+                                                      int rows, int cols,
+                                                      int tile_size,
+                                                      int cache_tiles) {
+  if (rows <= 0 || cols <= 0 || tile_size <= 0)
+    throw std::out_of_range(
+        "Incorrect input, rows, cols and tile size should be positive");
+  if (cache_tiles < kMinimumCacheTiles)
+    throw std::out_of_range("Incorrect input, cache needs three tiles");
+  Header header{};
+  std::memcpy(header.magic, kMagic, sizeof(kMagic));
+  header.byte_order = kByteOrder;
+  header.version = kVersion;
+  header.type = static_cast<std::uint8_t>(S21FileTypeOf<T>::kValue);
+  header.element_size = sizeof(T);
+  header.rows = rows;
+  header.cols = cols;
+  header.tile = tile_size;
+  header.data_offset = kDataOffset;
+  const int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC,
+                        0644);
+  if (fd < 0) fail_errno("Cannot open file", path);
+  S21BasicTiledMatrix sol(fd, path, rows, cols, tile_size, cache_tiles);
+  write_at(fd, &header, sizeof(header), 0, path);
+  // tiles never written read back as zeros
+  const long count = static_cast<long>(sol.tile_rows_) * sol.tile_cols_;
+  if (::ftruncate(fd, tile_offset<T>(count, tile_size)) != 0)
+    fail_errno("Cannot resize file", path);
+  return sol;
+}
+
+template <typename T>
+S21BasicTiledMatrix<T> S21BasicTiledMatrix<T>::Open(const std::string &path,
+                                                    int cache_tiles) {
+  if (cache_tiles < kMinimumCacheTiles)
+    throw std::out_of_range("Incorrect input, cache needs three tiles");
+  const int fd = ::open(path.c_str(), O_RDWR | O_CLOEXEC);
+  if (fd < 0) fail_errno("Cannot open file", path);
+  Header header;
+  try {
+    read_at(fd, &header, sizeof(header), 0, path);
+  } catch (...) {
+    ::close(fd);
+    throw;
+  }
+  const auto check = [&](bool ok, const char *what) {
+    if (!ok) {
+      ::close(fd);
+      fail(what, path);
+    }
+  };
+  check(std::memcmp(header.magic, kMagic, sizeof(kMagic)) == 0,
+        "Not a tiled matrix file");
+  check(header.byte_order == kByteOrder,
+        "Matrix file has a different byte order");
+  check(header.version == kVersion, "Unsupported matrix file version");
+  check(header.type ==
+                static_cast<std::uint8_t>(S21FileTypeOf<T>::kValue) &&
+            header.element_size == sizeof(T),
+        "Matrix file holds a different element type");
+  constexpr std::uint64_t max = std::numeric_limits<int>::max();
+  check(header.rows > 0 && header.cols > 0 && header.tile > 0 &&
+            header.rows <= max && header.cols <= max && header.tile <= max &&
+            header.data_offset == kDataOffset,
+        "Invalid matrix file header");
+  S21BasicTiledMatrix sol(fd, path, static_cast<int>(header.rows),
+                          static_cast<int>(header.cols),
+                          static_cast<int>(header.tile), cache_tiles);
+  struct stat st;
+  const long count = static_cast<long>(sol.tile_rows_) * sol.tile_cols_;
+  if (::fstat(fd, &st) != 0) fail_errno("Cannot stat file", path);
+  if (st.st_size < tile_offset<T>(count, sol.tile_))
+    fail("Matrix file is truncated", path);
+  return sol;
+}
+
+template <typename T>
+S21BasicTiledMatrix<T> S21BasicTiledMatrix<T>::FromMatrix(
+    const std::string &path, const Matrix &matrix, int tile_size,
+    int cache_tiles) {
+  S21BasicTiledMatrix sol = Create(path, matrix.getRows(), matrix.getCols(),
+                                   tile_size, cache_tiles);
+  for (int ti = 0; ti < sol.tile_rows_; ti++) {
+    for (int tj = 0; tj < sol.tile_cols_; tj++) {
+      Matrix tile(tile_size, tile_size);
+      const int rows = std::min(tile_size, sol.rows_ - ti * tile_size);
+      const int cols = std::min(tile_size, sol.cols_ - tj * tile_size);
+      for (int i = 0; i < rows; i++)
+        std::copy_n(matrix.data() +
+                        static_cast<long>(ti * tile_size + i) *
+                            matrix.stride() +
+                        tj * tile_size,
+                    cols, tile.data() + static_cast<long>(i) * tile_size);
+      sol.install(sol.key(ti, tj), std::move(tile));
+    }
+  }
+  sol.Flush();
+  return sol;
+}
+
+template <typename T>
+S21BasicTiledMatrix<T>::S21BasicTiledMatrix(
+    S21BasicTiledMatrix &&other) noexcept
+    : fd_(std::exchange(other.fd_, -1)),
+      path_(std::move(other.path_)),
+      rows_(other.rows_),
+      cols_(other.cols_),
+      tile_(other.tile_),
+      tile_rows_(other.tile_rows_),
+      tile_cols_(other.tile_cols_),
+      cache_tiles_(other.cache_tiles_),
+      lru_(std::move(other.lru_)),
+      index_(std::move(other.index_)),
+      pending_(std::move(other.pending_)) {}
+
+template <typename T>
+S21BasicTiledMatrix<T> &S21BasicTiledMatrix<T>::operator=(
+    S21BasicTiledMatrix &&other) noexcept {
+  if (this != &other) {
+    close();
+    fd_ = std::exchange(other.fd_, -1);
+    path_ = std::move(other.path_);
+    rows_ = other.rows_;
+    cols_ = other.cols_;
+    tile_ = other.tile_;
+    tile_rows_ = other.tile_rows_;
+    tile_cols_ = other.tile_cols_;
+    cache_tiles_ = other.cache_tiles_;
+    lru_ = std::move(other.lru_);
+    index_ = std::move(other.index_);
+    pending_ = std::move(other.pending_);
+  }
+  return *this;
+}
+
+template <typename T>
+S21BasicTiledMatrix<T>::~S21BasicTiledMatrix() {
+  close();
+}
+
+template <typename T>
+void S21BasicTiledMatrix<T>::close() noexcept {
+  if (fd_ < 0) return;
+  pending_.clear();  // waits for the reads in flight
+  try {
+    Flush();
+  } catch (...) {
+  }
+  lru_.clear();
+  index_.clear();
+  ::close(fd_);
+  fd_ = -1;
+}
+
+// Cache
+
+template <typename T>
+void S21BasicTiledMatrix<T>::check_tile(int ti, int tj) const {
+  if (ti >= tile_rows_ || tj >= tile_cols_)
+    throw std::out_of_range("Error! Value is out of range");
+  if (ti < 0 || tj < 0)
+    throw std::out_of_range("Error! Values should be positive");
+}
+
+template <typename T>
+S21BasicMatrix<T> &S21BasicTiledMatrix<T>::acquire(long key) const {
+  const auto cached = index_.find(key);
+  if (cached != index_.end()) {
+    lru_.splice(lru_.begin(), lru_, cached->second);
+    return cached->second->tile;
+  }
+  Matrix tile;
+  const auto loading = pending_.find(key);
+  if (loading != pending_.end()) {
+    std::future<Matrix> future = std::move(loading->second);
+    pending_.erase(loading);
+    tile = future.get();
+  } else {
+    tile = read_tile<T>(fd_, path_, tile_, key);
+  }
+  lru_.push_front({key, std::move(tile), false});
+  index_[key] = lru_.begin();
+  evict();
+  return lru_.front().tile;
+}
+
+template <typename T>
+void S21BasicTiledMatrix<T>::install(long key, Matrix &&tile) {
+  // a read in flight would bring back the old contents
+  pending_.erase(key);
+  const auto cached = index_.find(key);
+  if (cached != index_.end()) {
+    cached->second->tile = std::move(tile);
+    cached->second->dirty = true;
+    lru_.splice(lru_.begin(), lru_, cached->second);
+    return;
+  }
+  lru_.push_front({key, std::move(tile), true});
+  index_[key] = lru_.begin();
+  evict();
+}
+
+template <typename T>
+void S21BasicTiledMatrix<T>::prefetch(long key) const {
+  if (index_.count(key) != 0 || pending_.count(key) != 0) return;
+  pending_.emplace(key, std::async(std::launch::async,
+                                   [fd = fd_, path = path_, tile = tile_,
+                                    key] {
+                                     return read_tile<T>(fd, path, tile, key);
+                                   }));
+}
+
+template <typename T>
+void S21BasicTiledMatrix<T>::evict() const {
+  while (lru_.size() > static_cast<std::size_t>(cache_tiles_)) {
+    const Entry &last = lru_.back();
+    if (last.dirty) write_back(last);
+    index_.erase(last.key);
+    lru_.pop_back();
+  }
+}
+
+template <typename T>
+void S21BasicTiledMatrix<T>::write_back(const Entry &entry) const {
+  write_at(fd_, entry.tile.data(), sizeof(T) * tile_ * tile_,
+           tile_offset<T>(entry.key, tile_), path_);
+}
+
+template <typename T>
+void S21BasicTiledMatrix<T>::Flush() {
+  for (Entry &entry : lru_) {
+    if (!entry.dirty) continue;
+    write_back(entry);
+    entry.dirty = false;
+  }
+}
+
+// Element and tile access
+
+template <typename T>
+S21BasicMatrix<T> S21BasicTiledMatrix<T>::GetTile(int ti, int tj) const {
+  check_tile(ti, tj);
+  return acquire(key(ti, tj));
+}
+
+template <typename T>
+void S21BasicTiledMatrix<T>::SetTile(int ti, int tj, const Matrix &tile) {
+  check_tile(ti, tj);
+  if (tile.getRows() > tile_ || tile.getCols() > tile_)
+    throw std::out_of_range("Incorrect input, tile is too large");
+  // elements past the edge of the matrix stay zero
+  const int rows = std::min(tile.getRows(), rows_ - ti * tile_);
+  const int cols = std::min(tile.getCols(), cols_ - tj * tile_);
+  Matrix padded(tile_, tile_);
+  for (int i = 0; i < rows; i++)
+    std::copy_n(tile.data() + static_cast<long>(i) * tile.stride(), cols,
+                padded.data() + static_cast<long>(i) * tile_);
+  install(key(ti, tj), std::move(padded));
+}
+
+template <typename T>
+T S21BasicTiledMatrix<T>::Get(int i, int j) const {
+  if (i >= rows_ || j >= cols_)
+    throw std::out_of_range("Error! Value is out of range");
+  if (i < 0 || j < 0)
+    throw std::out_of_range("Error! Values should be positive");
+  return acquire(key(i / tile_, j / tile_)).at_unchecked(i % tile_, j % tile_);
+}
+
+template <typename T>
+void S21BasicTiledMatrix<T>::Set(int i, int j, T value) {
+  if (i >= rows_ || j >= cols_)
+    throw std::out_of_range("Error! Value is out of range");
+  if (i < 0 || j < 0)
+    throw std::out_of_range("Error! Values should be positive");
+  acquire(key(i / tile_, j / tile_)).at_unchecked(i % tile_, j % tile_) =
+      value;
+  lru_.front().dirty = true;
+}
+
+template <typename T>
+S21BasicMatrix<T> S21BasicTiledMatrix<T>::ToMatrix() const {
+  Matrix sol(rows_, cols_);
+  const long count = static_cast<long>(tile_rows_) * tile_cols_;
+  for (long k = 0; k < count; k++) {
+    if (k + 1 < count) prefetch(k + 1);
+    const Matrix &tile = acquire(k);
+    const int ti = k / tile_cols_, tj = k % tile_cols_;
+    const int rows = std::min(tile_, rows_ - ti * tile_);
+    const int cols = std::min(tile_, cols_ - tj * tile_);
+    for (int i = 0; i < rows; i++)
+      std::copy_n(tile.data() + static_cast<long>(i) * tile_, cols,
+                  sol.data() + static_cast<long>(ti * tile_ + i) *
+                                   sol.stride() +
+                      tj * tile_);
+  }
+  return sol;
+}
+
+// Operations
+
+template <typename T>
+void S21BasicTiledMatrix<T>::SumMatrix(const S21BasicTiledMatrix &other) {
+  if (rows_ != other.rows_ || cols_ != other.cols_ || tile_ != other.tile_)
+    throw std::out_of_range(
+        "Incorrect input, matrices should have the same size");
+  const long count = static_cast<long>(tile_rows_) * tile_cols_;
+  for (long k = 0; k < count; k++) {
+    if (k + 1 < count) {
+      prefetch(k + 1);
+      other.prefetch(k + 1);
+    }
+    Matrix &tile = acquire(k);
+    lru_.front().dirty = true;
+    tile.SumMatrix(other.acquire(k));
+  }
+}
+
+template <typename T>
+void S21BasicTiledMatrix<T>::SubMatrix(const S21BasicTiledMatrix &other) {
+  if (rows_ != other.rows_ || cols_ != other.cols_ || tile_ != other.tile_)
+    throw std::out_of_range(
+        "Incorrect input, matrices should have the same size");
+  const long count = static_cast<long>(tile_rows_) * tile_cols_;
+  for (long k = 0; k < count; k++) {
+    if (k + 1 < count) {
+      prefetch(k + 1);
+      other.prefetch(k + 1);
+    }
+    Matrix &tile = acquire(k);
+    lru_.front().dirty = true;
+    tile.SubMatrix(other.acquire(k));
+  }
+}
+
+template <typename T>
+void S21BasicTiledMatrix<T>::Multiply(S21BasicTiledMatrix &C,
+                                      const S21BasicTiledMatrix &A,
+                                      const S21BasicTiledMatrix &B) {
+  if (A.cols_ != B.rows_ || C.rows_ != A.rows_ || C.cols_ != B.cols_ ||
+      A.tile_ != B.tile_ || C.tile_ != A.tile_)
+    throw std::out_of_range(
+        "Incorrect input, matrices should have the same size");
+  if (&C == &A || &C == &B)
+    throw std::out_of_range(
+        "Incorrect input, the product cannot overwrite an operand");
+  const int tile = C.tile_, depth = A.tile_cols_;
+  for (int ti = 0; ti < C.tile_rows_; ti++) {
+    for (int tj = 0; tj < C.tile_cols_; tj++) {
+      Matrix sum(tile, tile);
+      for (int tk = 0; tk < depth; tk++) {
+        // the tiles of the next step load while this one multiplies
+        int ni = ti, nj = tj, nk = tk + 1;
+        if (nk == depth) {
+          nk = 0;
+          if (++nj == C.tile_cols_) {
+            nj = 0;
+            ni++;
+          }
+        }
+        if (ni < C.tile_rows_) {
+          A.prefetch(A.key(ni, nk));
+          B.prefetch(B.key(nk, nj));
+        }
+        const Matrix &a = A.acquire(A.key(ti, tk));
+        const Matrix &b = B.acquire(B.key(tk, tj));
+        Matrix::Multiply(sum, a, b, T(1), T(1));
+      }
+      C.install(C.key(ti, tj), std::move(sum));
+    }
+  }
+}
+
+template <typename T>
+void S21BasicTiledMatrix<T>::MulMatrix(const S21BasicTiledMatrix &other) {
+  const std::string temporary = path_ + ".tmp";
+  S21BasicTiledMatrix sol =
+      Create(temporary, rows_, other.cols_, tile_, cache_tiles_);
+  Multiply(sol, *this, other);
+  sol.Flush();
+  if (std::rename(temporary.c_str(), path_.c_str()) != 0)
+    fail_errno("Cannot replace file", path_);
+  // the old tiles went with the old file
+  pending_.clear();
+  lru_.clear();
+  index_.clear();
+  sol.path_ = path_;
+  *this = std::move(sol);
+}
+
+template <typename T>
+S21BasicTiledMatrix<T> S21BasicTiledMatrix<T>::Transpose(
+    const std::string &path) const {
+  S21BasicTiledMatrix sol = Create(path, cols_, rows_, tile_, cache_tiles_);
+  const long count = static_cast<long>(tile_rows_) * tile_cols_;
+  for (long k = 0; k < count; k++) {
+    if (k + 1 < count) prefetch(k + 1);
+    const int ti = k / tile_cols_, tj = k % tile_cols_;
+    sol.install(sol.key(tj, ti), acquire(k).Transpose());
+  }
+  return sol;
+}
+
+template class S21BasicTiledMatrix<float>;
+template class S21BasicTiledMatrix<double>;
+template class S21BasicTiledMatrix<long double>;
+template class S21BasicTiledMatrix<std::complex<double>>;
@@ -0,0 +1,133 @@
+#ifndef MATRIX_SRC_S21_TILED_MATRIX_H
+#define MATRIX_SRC_S21_TILED_MATRIX_H
+
+#include <complex>
+#include <future>
+#include <list>
+#include <string>
+#include <unordered_map>
+
+#include "s21_matrix_oop.h"
+
+// Disk-backed matrix for sizes that do not fit in memory. The file holds
+// square tiles of getTileSize() x getTileSize() elements, each one
+// contiguous and row-major; tiles on the right and bottom edges are padded
+// with zeros so that every tile has the same shape. At most cacheTiles()
+// tiles live in memory in an LRU cache; changed tiles are written back
+// when they are evicted, on Flush() and on destruction.
+//
+// The operations walk the tiles in order, start reading the tiles needed
+// next on a background thread while the current ones are processed, and
+// run the in-memory S21BasicMatrix kernels (Multiply, SumMatrix, ...) on
+// each tile. For products the cache should hold a row of tiles of the left
+// operand plus two, then every left tile is read only once.
+//
+// Dimension mismatches throw std::out_of_range, I/O and format errors
+// std::runtime_error.
+template <typename T>
+class S21BasicTiledMatrix {
+ public:
+  using value_type = T;
+  using Matrix = S21BasicMatrix<T>;
+  static constexpr int kDefaultTileSize = 512;
+  static constexpr int kDefaultCacheTiles = 64;
+
+ private:
+  struct Entry {
+    long key;
+    Matrix tile;
+    bool dirty;
+  };
+  using EntryList = std::list<Entry>;
+
+  // Attributes
+  int fd_;
+  std::string path_;
+  int rows_, cols_;
+  int tile_;                  // Tile edge in elements
+  int tile_rows_, tile_cols_;  // Tiles down and across
+  int cache_tiles_;
+  // Cache, most recently used first; reads change it, so it is mutable
+  mutable EntryList lru_;
+  mutable std::unordered_map<long, typename EntryList::iterator> index_;
+  mutable std::unordered_map<long, std::future<Matrix>> pending_;
+
+  S21BasicTiledMatrix(int fd, std::string path, int rows, int cols, int tile,
+                      int cache_tiles);
+  [[nodiscard]] long key(int ti, int tj) const noexcept {
+    return static_cast<long>(ti) * tile_cols_ + tj;
+  }
+  void check_tile(int ti, int tj) const;
+  // Cached tile, read from the prefetch or the file when missing; stays
+  // valid until two other tiles of this matrix have been acquired
+  Matrix &acquire(long key) const;
+  // Puts `tile` in the cache as the new, changed contents of a tile
+  void install(long key, Matrix &&tile);
+  // Starts reading a tile in the background unless it is cached already
+  void prefetch(long key) const;
+  void evict() const;
+  void write_back(const Entry &entry) const;
+  void close() noexcept;
+
+ public:
+  // New file of zeros, sparse where the file system allows it
+  static S21BasicTiledMatrix Create(const std::string &path, int rows,
+                                    int cols,
+                                    int tile_size = kDefaultTileSize,
+                                    int cache_tiles = kDefaultCacheTiles);
+  // Existing file
+  static S21BasicTiledMatrix Open(const std::string &path,
+                                  int cache_tiles = kDefaultCacheTiles);
+  // New file with the elements of an in-memory matrix
+  static S21BasicTiledMatrix FromMatrix(
+      const std::string &path, const Matrix &matrix,
+      int tile_size = kDefaultTileSize,
+      int cache_tiles = kDefaultCacheTiles);
+
+  S21BasicTiledMatrix(const S21BasicTiledMatrix &) = delete;
+  S21BasicTiledMatrix &operator=(const S21BasicTiledMatrix &) = delete;
+  S21BasicTiledMatrix(S21BasicTiledMatrix &&other) noexcept;
+  S21BasicTiledMatrix &operator=(S21BasicTiledMatrix &&other) noexcept;
+  // Flushes; errors are only reported by Flush()
+  ~S21BasicTiledMatrix();
+
+  [[nodiscard]] int getRows() const noexcept { return rows_; }
+  [[nodiscard]] int getCols() const noexcept { return cols_; }
+  [[nodiscard]] int getTileSize() const noexcept { return tile_; }
+  // Tiles down and across
+  [[nodiscard]] int TileRows() const noexcept { return tile_rows_; }
+  [[nodiscard]] int TileCols() const noexcept { return tile_cols_; }
+  [[nodiscard]] int cacheTiles() const noexcept { return cache_tiles_; }
+  [[nodiscard]] const std::string &getPath() const noexcept { return path_; }
+
+  // Copy of tile (ti, tj), getTileSize() square with the padding
+  [[nodiscard]] Matrix GetTile(int ti, int tj) const;
+  // Replaces tile (ti, tj); a smaller `tile` is padded with zeros
+  void SetTile(int ti, int tj, const Matrix &tile);
+  [[nodiscard]] T Get(int i, int j) const;
+  void Set(int i, int j, T value);
+  // The whole matrix in memory
+  [[nodiscard]] Matrix ToMatrix() const;
+  // Writes every changed tile to the file
+  void Flush();
+
+  void SumMatrix(const S21BasicTiledMatrix &other);
+  void SubMatrix(const S21BasicTiledMatrix &other);
+  // *this = *this * other through a temporary file next to this one,
+  // which then replaces it
+  void MulMatrix(const S21BasicTiledMatrix &other);
+  // C = A * B into an existing matrix of the product's shape, not A or B
+  static void Multiply(S21BasicTiledMatrix &C, const S21BasicTiledMatrix &A,
+                       const S21BasicTiledMatrix &B);
+  // Transpose in a new file
+  [[nodiscard]] S21BasicTiledMatrix Transpose(const std::string &path) const;
+};
+
+using S21TiledMatrix = S21BasicTiledMatrix<double>;
+
+extern template class S21BasicTiledMatrix<float>;
+extern template class S21BasicTiledMatrix<double>;
+extern template class S21BasicTiledMatrix<long double>;
+extern template class S21BasicTiledMatrix<std::complex<double>>;
+
+#endif  // MATRIX_SRC_S21_TILED_MATRIX_H